@@ -0,0 +1,71 @@
+#include "../handler/api_base.h"
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <thread>
+#include <vector>
+
+namespace {
+
+constexpr int kEventsPerThread = 500000;
+
+// 多线程并发调用 ApiBase::process，返回总吞吐（百万事件/秒）
+double run_threads(proj::event::ApiBase& api, int thread_count) {
+    const proj::event::OpAddEvent event("add_0", "tensor_0", "tensor_1", "tensor_2");
+    std::atomic<bool> start(false);
+    std::vector<std::thread> threads;
+    for (int t = 0; t < thread_count; ++t) {
+        threads.emplace_back([&]() {
+            while (!start.load(std::memory_order_acquire)) {
+                std::this_thread::yield();
+            }
+            for (int i = 0; i < kEventsPerThread; ++i) {
+                api.process(event);
+            }
+        });
+    }
+
+    auto begin = std::chrono::steady_clock::now();
+    start.store(true, std::memory_order_release);
+    for (auto& t : threads) {
+        t.join();
+    }
+    auto end = std::chrono::steady_clock::now();
+
+    double seconds = std::chrono::duration<double>(end - begin).count();
+    return static_cast<double>(kEventsPerThread) * thread_count / seconds / 1e6;
+}
+
+} // namespace
+
+// ApiBase::process 分发吞吐随线程数的变化；处理器只做线程内计数，测量的是查表与分发本身的成本
+int main() {
+    proj_logger::set_global_log_level(proj_logger::LogLevel::WARN);
+
+    proj::event::ApiBase api;
+    api.register_handler<proj::event::OpAddEvent>([](const proj::event::OpAddEvent&) {
+        thread_local uint64_t handled = 0;
+        ++handled;
+    });
+    api.register_handler<proj::event::TensorEvent>([](const proj::event::TensorEvent&) {});
+
+    std::printf("%-8s %-20s %-20s\n", "threads", "Mevents/s", "ns/event/thread");
+    for (int threads : {1, 2, 4, 8, 16, 32}) {
+        double mops = run_threads(api, threads);
+        std::printf("%-8d %-20.2f %-20.2f\n", threads, mops, 1e3 * threads / mops);
+    }
+
+    // 批量处理：同样的事件按每批 kBatchSize 个调用 process_batch（单线程）
+    constexpr int kBatchSize = 1000;
+    std::vector<proj::event::OpAddEvent> batch(kBatchSize,
+                                              proj::event::OpAddEvent("add_0", "tensor_0", "tensor_1", "tensor_2"));
+    auto begin = std::chrono::steady_clock::now();
+    for (int i = 0; i < kEventsPerThread / kBatchSize; ++i) {
+        api.process_batch<proj::event::OpAddEvent>(batch);
+    }
+    auto end = std::chrono::steady_clock::now();
+    double seconds = std::chrono::duration<double>(end - begin).count();
+    double mops = static_cast<double>(kEventsPerThread) / seconds / 1e6;
+    std::printf("%-8s %-20.2f %-20.2f\n", "batch", mops, 1e3 / mops);
+    return 0;
+}
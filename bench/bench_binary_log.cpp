@@ -0,0 +1,92 @@
+#include "../proj_logger/proj_logger.h"
+#include <spdlog/sinks/base_sink.h>
+#include <atomic>
+#include <chrono>
+#include <ctime>
+#include <cstdio>
+#include <cstdlib>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace {
+
+constexpr int kCallsPerThread = 100000;
+
+// 只做完整pattern格式化、不做IO的sink，隔离出文本模式的格式化成本
+class FormatOnlySink : public spdlog::sinks::base_sink<std::mutex> {
+protected:
+    void sink_it_(const spdlog::details::log_msg& msg) override {
+        spdlog::memory_buf_t formatted;
+        formatter_->format(msg, formatted);
+        bytes_ += formatted.size();
+    }
+    void flush_() override {}
+
+private:
+    size_t bytes_ = 0;
+};
+
+// 当前线程消耗的CPU时间（纳秒），不计入后台线程与调度等待
+int64_t thread_cpu_ns() {
+    timespec ts;
+    clock_gettime(CLOCK_THREAD_CPUTIME_ID, &ts);
+    return static_cast<int64_t>(ts.tv_sec) * 1000000000 + ts.tv_nsec;
+}
+
+// 多线程并发执行 body，返回调用线程上每次调用的平均CPU耗时（纳秒）
+template <typename Body>
+double run_threads(int thread_count, Body body) {
+    std::atomic<bool> start(false);
+    std::atomic<int64_t> total_ns(0);
+    std::vector<std::thread> threads;
+    for (int t = 0; t < thread_count; ++t) {
+        threads.emplace_back([&, t]() {
+            while (!start.load(std::memory_order_acquire)) {
+                std::this_thread::yield();
+            }
+            int64_t begin = thread_cpu_ns();
+            for (int i = 0; i < kCallsPerThread; ++i) {
+                body(t, i);
+            }
+            total_ns += thread_cpu_ns() - begin;
+        });
+    }
+    start.store(true, std::memory_order_release);
+    for (auto& t : threads) {
+        t.join();
+    }
+    return static_cast<double>(total_ns.load()) / (static_cast<double>(kCallsPerThread) * thread_count);
+}
+
+} // namespace
+
+// 对比调用线程上的开销：文本模式（参数格式化+完整pattern，不做IO）与二进制模式（仅记录原始参数）
+int main() {
+    // 每线程环需容纳一轮全部记录，避免后台来不及排空时丢弃
+    setenv("PROJ_LOG_BINARY_RING", "16777216", 1);
+
+    auto format_sink = std::make_shared<FormatOnlySink>();
+    spdlog::logger text_logger("BENCH", format_sink);
+    text_logger.set_pattern("[%Y-%m-%d %H:%M:%S.%e] [%n] [%l] [%s:%#] %v");
+    const uint32_t site = proj_logger::register_log_site(
+        "BENCH", proj_logger::LogLevel::INFO, __FILE__, __LINE__, "BackClass process data: 0x{:<8x}, var {}");
+    const std::string var = "just testing";
+
+    proj_logger::BinaryLogBackend backend(format_sink, "");
+
+    std::printf("%-8s %-20s %-20s %-10s\n", "threads", "text(ns/call)", "binary(ns/call)", "dropped");
+    for (int threads : {1, 2, 4, 8}) {
+        double text_ns = run_threads(threads, [&](int, int i) {
+            text_logger.log(spdlog::source_loc(__FILE__, __LINE__, ""), spdlog::level::info,
+                            "BackClass process data: 0x{:<8x}, var {}", i, var);
+        });
+        double binary_ns = run_threads(threads, [&](int, int i) {
+            proj_logger::binary_log(site, i, var);
+        });
+        backend.flush();
+        std::printf("%-8d %-20.2f %-20.2f %-10llu\n", threads, text_ns, binary_ns,
+                    static_cast<unsigned long long>(proj_logger::BinaryLogBackend::dropped()));
+    }
+    return 0;
+}
@@ -0,0 +1,63 @@
+#include "../handler/api_base.h"
+#include "../engine_base/thread_pool.h"
+#include "../engine_base/work_stealing_executor.h"
+#include <chrono>
+#include <cstdio>
+#include <memory>
+
+namespace {
+
+constexpr int kEvents = 200000;
+constexpr int kExpensiveEvery = 64;   // 每64个事件夹杂一个昂贵事件
+constexpr int kExpensiveSpinUs = 50;  // 昂贵事件的处理耗时
+
+void spin_for(std::chrono::microseconds d) {
+    auto until = std::chrono::steady_clock::now() + d;
+    while (std::chrono::steady_clock::now() < until) {
+    }
+}
+
+// 通过 ApiBase::post 投递代价不均的事件流：廉价 TensorEvent 夹杂昂贵 OpMMAEvent，返回总耗时（毫秒）
+double run(std::shared_ptr<Executor> executor) {
+    proj::event::PostConfig config;
+    config.executor = std::move(executor);
+    proj::event::ApiBase api(config);
+    api.register_handler<proj::event::TensorEvent>([](const proj::event::TensorEvent&) {
+        thread_local uint64_t handled = 0;
+        ++handled;
+    });
+    api.register_handler<proj::event::OpMMAEvent>([](const proj::event::OpMMAEvent&) {
+        spin_for(std::chrono::microseconds(kExpensiveSpinUs));
+    });
+
+    const proj::event::TensorEvent cheap("t", {1}, "float32");
+    const proj::event::OpMMAEvent expensive("mma", "a", "b", "c", "out");
+    auto begin = std::chrono::steady_clock::now();
+    for (int i = 0; i < kEvents; ++i) {
+        if (i % kExpensiveEvery == 0) {
+            api.post(expensive);
+        } else {
+            api.post(cheap);
+        }
+    }
+    api.drain();
+    auto end = std::chrono::steady_clock::now();
+    return std::chrono::duration<double, std::milli>(end - begin).count();
+}
+
+} // namespace
+
+// 共享队列线程池与工作窃取执行器在代价倾斜负载下的对比
+int main() {
+    proj_logger::set_global_log_level(proj_logger::LogLevel::WARN);
+
+    std::printf("%-8s %-20s %-20s %-12s\n", "workers", "ThreadPool(ms)", "WorkStealing(ms)", "steals");
+    for (size_t workers : {1, 2, 4, 8}) {
+        double pool_ms = run(std::make_shared<ThreadPool>(workers, 4096));
+        auto stealing = std::make_shared<WorkStealingExecutor>(workers, 4096);
+        double stealing_ms = run(stealing);
+        std::printf("%-8zu %-20.1f %-20.1f %-12llu\n", workers, pool_ms, stealing_ms,
+                    static_cast<unsigned long long>(stealing->steal_count()));
+    }
+    return 0;
+}
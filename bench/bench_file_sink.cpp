@@ -0,0 +1,85 @@
+#include "../proj_logger/proj_logger.h"
+#include <spdlog/sinks/basic_file_sink.h>
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <string>
+#include <thread>
+#include <vector>
+#include <unistd.h>
+
+namespace {
+
+constexpr int kCallsPerThread = 200000;
+
+// 多线程并发写入同一个日志器，返回吞吐（条/秒）
+double run_threads(spdlog::logger& logger, int thread_count) {
+    std::atomic<bool> start(false);
+    std::vector<std::thread> threads;
+    for (int t = 0; t < thread_count; ++t) {
+        threads.emplace_back([&, t]() {
+            while (!start.load(std::memory_order_acquire)) {
+                std::this_thread::yield();
+            }
+            for (int i = 0; i < kCallsPerThread; ++i) {
+                logger.info("OpAdd name=add_{} tensor_{} + tensor_{} -> tensor_{}", i, t, i + 1, i + 2);
+            }
+        });
+    }
+
+    auto begin = std::chrono::steady_clock::now();
+    start.store(true, std::memory_order_release);
+    for (auto& t : threads) {
+        t.join();
+    }
+    logger.flush();
+    auto end = std::chrono::steady_clock::now();
+
+    double seconds = std::chrono::duration<double>(end - begin).count();
+    return static_cast<double>(kCallsPerThread) * thread_count / seconds;
+}
+
+void remove_segments(const std::string& base) {
+    for (int i = 0; std::remove((base + "." + std::to_string(i)).c_str()) == 0; ++i) {
+    }
+}
+
+} // namespace
+
+// 对比spdlog basic_file_sink（每条日志一次write）与mmap段文件sink（拷贝进映射区）的写入吞吐
+// 用法：bench_file_sink [目录]，默认 /tmp
+int main(int argc, char** argv) {
+    const std::string dir = argc > 1 ? argv[1] : "/tmp";
+    const std::string pattern = "[%Y-%m-%d %H:%M:%S.%e] [%n] [%l] [%s:%#] %v";
+
+    std::printf("%-8s %-22s %-22s %-8s\n", "threads", "basic_file(msg/s)", "mmap_file(msg/s)", "speedup");
+    for (int threads : {1, 2, 4, 8}) {
+        const std::string basic_path = dir + "/bench_basic_" + std::to_string(::getpid()) + ".log";
+        double basic_rate = 0;
+        {
+            // 不缓冲：与stdout重定向到文件时一样，每条日志落一次write
+            auto sink = std::make_shared<spdlog::sinks::basic_file_sink_mt>(basic_path, true);
+            spdlog::logger logger("BENCH", sink);
+            logger.set_pattern(pattern);
+            logger.flush_on(spdlog::level::info);
+            basic_rate = run_threads(logger, threads);
+        }
+        std::remove(basic_path.c_str());
+
+        const std::string mmap_base = dir + "/bench_mmap_" + std::to_string(::getpid()) + ".log";
+        double mmap_rate = 0;
+        {
+            proj_logger::MmapFileSinkConfig config;
+            config.path = mmap_base;
+            auto sink = std::make_shared<proj_logger::MmapFileSink>(config);
+            spdlog::logger logger("BENCH", sink);
+            logger.set_pattern(pattern);
+            mmap_rate = run_threads(logger, threads);
+        }
+        remove_segments(mmap_base);
+
+        std::printf("%-8d %-22.0f %-22.0f %-8.2f\n", threads, basic_rate, mmap_rate, mmap_rate / basic_rate);
+    }
+    return 0;
+}
@@ -0,0 +1,59 @@
+#include "../engine_base/inline_function.h"
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <functional>
+#include <vector>
+
+namespace {
+
+constexpr int kCalls = 20000000;
+constexpr uint32_t kSlots = 8;
+
+struct Event {
+    uint64_t value;
+};
+
+// 按稠密下标分发，模拟处理器表：外层可调用对象把 const void* 还原为具体事件再调用内层处理器
+template <typename Table>
+double run(const Table& table, uint64_t& sink) {
+    Event event{1};
+    auto begin = std::chrono::steady_clock::now();
+    for (int i = 0; i < kCalls; ++i) {
+        table[static_cast<uint32_t>(i) % kSlots](&event);
+    }
+    auto end = std::chrono::steady_clock::now();
+    sink += event.value;
+    return std::chrono::duration<double, std::nano>(end - begin).count() / kCalls;
+}
+
+} // namespace
+
+// std::function 与 InlineFunction 的分发成本对比
+// 旧实现：std::function<void(const Event&)> 再包一层 std::function<void(const void*)>（两次间接调用）
+// 新实现：处理器直接内联在 InlineFunction<void(const void*)> 中（一次间接调用，无堆分配）
+int main() {
+    uint64_t sink = 0;
+    uint64_t counter = 0;
+
+    std::vector<std::function<void(const void*)>> std_table;
+    std::vector<InlineFunction<void(const void*)>> inline_table;
+    for (uint32_t i = 0; i < kSlots; ++i) {
+        std::function<void(const Event&)> handler = [&counter](const Event& e) { counter += e.value; };
+        std_table.emplace_back([handler = std::move(handler)](const void* p) {
+            handler(*static_cast<const Event*>(p));
+        });
+        inline_table.emplace_back([&counter](const void* p) {
+            counter += static_cast<const Event*>(p)->value;
+        });
+    }
+
+    double std_ns = run(std_table, sink);
+    double inline_ns = run(inline_table, sink);
+
+    std::printf("%-24s %-12s\n", "dispatch", "ns/call");
+    std::printf("%-24s %-12.2f\n", "std::function (nested)", std_ns);
+    std::printf("%-24s %-12.2f\n", "InlineFunction", inline_ns);
+    std::printf("(checksum %llu)\n", static_cast<unsigned long long>(sink + counter));
+    return 0;
+}
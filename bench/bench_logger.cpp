@@ -0,0 +1,61 @@
+#include "../proj_logger/proj_logger.h"
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <thread>
+#include <vector>
+
+// 基准模块日志器名称
+#define BENCH_LOGGER_NAME "BENCH"
+
+namespace {
+
+constexpr int kCallsPerThread = 200000;
+
+// 多线程并发执行 body，返回每次调用的平均耗时（纳秒）
+template <typename Body>
+double run_threads(int thread_count, Body body) {
+    std::atomic<bool> start(false);
+    std::vector<std::thread> threads;
+    for (int t = 0; t < thread_count; ++t) {
+        threads.emplace_back([&, t]() {
+            while (!start.load(std::memory_order_acquire)) {
+                std::this_thread::yield();
+            }
+            for (int i = 0; i < kCallsPerThread; ++i) {
+                body(t, i);
+            }
+        });
+    }
+
+    auto begin = std::chrono::steady_clock::now();
+    start.store(true, std::memory_order_release);
+    for (auto& t : threads) {
+        t.join();
+    }
+    auto end = std::chrono::steady_clock::now();
+
+    double total_ns = std::chrono::duration<double, std::nano>(end - begin).count();
+    return total_ns / (static_cast<double>(kCallsPerThread) * thread_count);
+}
+
+} // namespace
+
+// 对比按名称查找日志器（旧路径）与调用点缓存句柄（宏路径）的多线程开销
+// 日志级别为INFO，DEBUG消息被过滤，测量的是日志器解析本身的成本
+int main() {
+    proj_logger::set_global_log_level(proj_logger::LogLevel::INFO);
+
+    std::printf("%-8s %-20s %-20s %-8s\n", "threads", "lookup(ns/call)", "cached(ns/call)", "speedup");
+    for (int threads : {1, 2, 4, 8, 16, 32}) {
+        double lookup_ns = run_threads(threads, [](int t, int i) {
+            proj_logger::log(proj_logger::LogLevel::DEBUG, BENCH_LOGGER_NAME,
+                             __FILE__, __LINE__, "filtered {} {}", t, i);
+        });
+        double cached_ns = run_threads(threads, [](int t, int i) {
+            MALOG_DEBG(BENCH_LOGGER_NAME, "filtered {} {}", t, i);
+        });
+        std::printf("%-8d %-20.2f %-20.2f %-8.2f\n", threads, lookup_ns, cached_ns, lookup_ns / cached_ns);
+    }
+    return 0;
+}
@@ -0,0 +1,56 @@
+#include "../handler/api_base.h"
+#include "../engine_base/object_pool.h"
+#include <chrono>
+#include <cstdio>
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace {
+
+constexpr int kIterations = 2000000;
+
+template <typename Fn>
+double ns_per_op(Fn&& fn) {
+    auto begin = std::chrono::steady_clock::now();
+    for (int i = 0; i < kIterations; ++i) {
+        fn(i);
+    }
+    auto end = std::chrono::steady_clock::now();
+    return std::chrono::duration<double, std::nano>(end - begin).count() / kIterations;
+}
+
+} // namespace
+
+// 事件构造成本：每次 make_unique 新建 vs 对象池回收复用（名称超出SSO长度，新建时每个字符串都分配）
+int main() {
+    const std::string name = "op_add_with_a_fairly_long_name_0001";
+    const std::string in1 = "input_tensor_with_long_name_0001";
+    const std::string in2 = "input_tensor_with_long_name_0002";
+    const std::string out = "output_tensor_with_long_name_0003";
+    const std::vector<int64_t> shape = {32, 128, 128, 64};
+    size_t sink = 0;
+
+    double add_new = ns_per_op([&](int) {
+        auto event = std::make_unique<proj::event::OpAddEvent>(name, in1, in2, out);
+        sink += event->name().size();
+    });
+    double add_pool = ns_per_op([&](int) {
+        auto event = ObjectPool<proj::event::OpAddEvent>::make(name, in1, in2, out);
+        sink += event->name().size();
+    });
+    double tensor_new = ns_per_op([&](int) {
+        auto event = std::make_unique<proj::event::TensorEvent>(name, shape, "float32");
+        sink += event->shape().size();
+    });
+    double tensor_pool = ns_per_op([&](int) {
+        auto event = ObjectPool<proj::event::TensorEvent>::make(name, shape, "float32");
+        sink += event->shape().size();
+    });
+
+    std::printf("%-14s %-14s %-14s\n", "event", "new(ns)", "pool(ns)");
+    std::printf("%-14s %-14.1f %-14.1f\n", "OpAddEvent", add_new, add_pool);
+    std::printf("%-14s %-14.1f %-14.1f\n", "TensorEvent", tensor_new, tensor_pool);
+    std::printf("(checksum %zu)\n", sink);
+    return 0;
+}
@@ -0,0 +1,117 @@
+#include "../handler/router.h"
+#include <any>
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <functional>
+#include <memory>
+#include <string>
+#include <type_traits>
+#include <typeindex>
+#include <unordered_map>
+
+namespace {
+
+constexpr int kIterations = 20000000;
+
+template <typename Fn>
+double ns_per_op(Fn&& fn) {
+    auto begin = std::chrono::steady_clock::now();
+    for (int i = 0; i < kIterations; ++i) {
+        fn();
+    }
+    auto end = std::chrono::steady_clock::now();
+    return std::chrono::duration<double, std::nano>(end - begin).count() / kIterations;
+}
+
+} // namespace
+
+// 1. 处理器获取成本：旧实现按 type_index 查哈希表再 any_cast 拷贝 shared_ptr（引用计数增减）
+// 新实现按类型直接取 Router 内 tuple 成员，返回裸指针
+// 2. Router::dispatch 整条路径（INFO 日志关闭，OpAdd 实现只做计数）：串行模式每条消息加解一次全局锁，
+// 并发模式只读路由表与实现表
+// 3. OpAdd 实现选择：旧实现按整个名字串哈希查表，未命中再查一次 "default"；
+// 新实现按实现名符号ID在冻结的扁平表上整数比较，未命中直接取缓存的默认实现；
+// 分别测按字符串先在驻留表中查找（不插入）与直接使用消息构造时已查到的符号
+int main() {
+    proj_logger::set_global_log_level(proj_logger::LogLevel::WARN);
+
+    using proj::msg::OpAddMsg;
+    using proj::msg::OpAddProcessor;
+    static_assert(std::is_same_v<decltype(std::declval<proj::msg::Router&>().get_processor<OpAddMsg>()),
+                                 OpAddProcessor*>,
+                  "get_processor must not return a reference-counted handle");
+
+    std::unordered_map<std::type_index, std::any> legacy;
+    legacy[std::type_index(typeid(OpAddMsg))] = std::make_shared<OpAddProcessor>();
+    proj::msg::Router router;
+    volatile uintptr_t sink = 0;
+
+    double legacy_ns = ns_per_op([&]() {
+        auto processor = std::any_cast<std::shared_ptr<OpAddProcessor>>(
+            legacy.at(std::type_index(typeid(OpAddMsg))));
+        sink = reinterpret_cast<uintptr_t>(processor.get());
+    });
+    double tuple_ns = ns_per_op([&]() {
+        sink = reinterpret_cast<uintptr_t>(router.get_processor<OpAddMsg>());
+    });
+
+    std::printf("%-32s %-12s\n", "get_processor", "ns/op");
+    std::printf("%-32s %-12.2f\n", "map + any_cast<shared_ptr>", legacy_ns);
+    std::printf("%-32s %-12.2f\n", "tuple member (raw pointer)", tuple_ns);
+
+    uint64_t handled = 0;
+    auto count = [&handled](const OpAddMsg&) { ++handled; };
+    proj::msg::Router serialized(proj::msg::DispatchMode::SERIALIZED);
+    proj::msg::Router concurrent(proj::msg::DispatchMode::CONCURRENT);
+    serialized.get_add_processor()->register_impl("bench_add", count);
+    concurrent.get_add_processor()->register_impl("bench_add", count);
+    const OpAddMsg add("bench_add", "tensor_0", "tensor_1", "tensor_2");
+
+    double serialized_ns = ns_per_op([&]() { serialized.dispatch(add); });
+    double concurrent_ns = ns_per_op([&]() { concurrent.dispatch(add); });
+
+    std::printf("\n%-32s %-12s\n", "dispatch (OpAdd)", "ns/msg");
+    std::printf("%-32s %-12.2f\n", "Router SERIALIZED", serialized_ns);
+    std::printf("%-32s %-12.2f\n", "Router CONCURRENT", concurrent_ns);
+    std::printf("(handled %llu)\n", static_cast<unsigned long long>(handled));
+
+    // 查询名轮换，避免编译器把对常量名字的哈希提到循环外
+    const std::string hits[] = {"special", "fused", "tiled", "vectorized"};
+    const std::string misses[] = {"op_add_with_a_fairly_long_name_0001", "op_add_with_a_fairly_long_name_0002",
+                                  "op_add_with_a_fairly_long_name_0003", "op_add_with_a_fairly_long_name_0004"};
+    unsigned next = 0;
+    std::unordered_map<std::string, std::function<void(const OpAddMsg&)>> legacy_impls;
+    for (const char* name : {"default", "special", "fused", "tiled", "vectorized"}) {
+        legacy_impls[name] = [](const OpAddMsg&) {};
+    }
+    auto legacy_select = [&](const std::string& name) {
+        auto it = legacy_impls.find(name);
+        return &(it != legacy_impls.end() ? it->second : legacy_impls["default"]);
+    };
+    OpAddProcessor* processor = router.get_add_processor();
+    for (const char* name : {"fused", "tiled", "vectorized"}) {
+        processor->register_impl(name, [](const OpAddMsg&) {});
+    }
+
+    double legacy_hit_ns = ns_per_op([&]() { sink = reinterpret_cast<uintptr_t>(legacy_select(hits[++next & 3])); });
+    double legacy_miss_ns = ns_per_op([&]() { sink = reinterpret_cast<uintptr_t>(legacy_select(misses[++next & 3])); });
+    double frozen_hit_ns = ns_per_op([&]() { sink = reinterpret_cast<uintptr_t>(processor->find_impl(hits[++next & 3])); });
+    double frozen_miss_ns = ns_per_op([&]() { sink = reinterpret_cast<uintptr_t>(processor->find_impl(misses[++next & 3])); });
+    // 消息构造时已查到的符号：分发只做整数比较
+    Symbol hit_symbols[4];
+    Symbol miss_symbols[4];
+    for (int i = 0; i < 4; ++i) {
+        hit_symbols[i] = Symbol::lookup(hits[i]);
+        miss_symbols[i] = Symbol::lookup(misses[i]);
+    }
+    double symbol_hit_ns = ns_per_op([&]() { sink = reinterpret_cast<uintptr_t>(processor->find_impl(hit_symbols[++next & 3])); });
+    double symbol_miss_ns = ns_per_op([&]() { sink = reinterpret_cast<uintptr_t>(processor->find_impl(miss_symbols[++next & 3])); });
+
+    std::printf("\n%-32s %-12s %-12s\n", "impl select", "hit ns/op", "miss ns/op");
+    std::printf("%-32s %-12.2f %-12.2f\n", "unordered_map<string> + default", legacy_hit_ns, legacy_miss_ns);
+    std::printf("%-32s %-12.2f %-12.2f\n", "Symbol::lookup + frozen table", frozen_hit_ns, frozen_miss_ns);
+    std::printf("%-32s %-12.2f %-12.2f\n", "frozen table (msg symbol)", symbol_hit_ns, symbol_miss_ns);
+    std::printf("(checksum %llu)\n", static_cast<unsigned long long>(sink & 1));
+    return 0;
+}
@@ -0,0 +1,72 @@
+#include "../handler/router.h"
+#include "../handler/static_router.h"
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <deque>
+#include <variant>
+
+namespace {
+
+using proj::msg::DispatchMode;
+using proj::msg::OpAddMsg;
+using proj::msg::OpMMAMsg;
+using proj::msg::Router;
+using Static = proj::msg::StaticRouter<OpAddMsg, OpMMAMsg>;
+
+constexpr int kIterations = 5000000;
+constexpr int kStreamSize = 1024;
+
+template <typename Fn>
+double ns_per_msg(Fn&& fn) {
+    auto begin = std::chrono::steady_clock::now();
+    for (int i = 0; i < kIterations; ++i) {
+        fn(i);
+    }
+    auto end = std::chrono::steady_clock::now();
+    return std::chrono::duration<double, std::nano>(end - begin).count() / kIterations;
+}
+
+} // namespace
+
+// 动态 Router 与编译期 StaticRouter 的单线程分发成本（INFO 日志关闭，OpAdd 实现只做计数）
+// 同构：反复分发同一条 OpAddMsg；异构：OpAdd/OpMMA 交替的 variant 消息流
+int main() {
+    proj_logger::set_global_log_level(proj_logger::LogLevel::WARN);
+
+    uint64_t handled = 0;
+    auto count = [&handled](const OpAddMsg&) { ++handled; };
+    Router serialized(DispatchMode::SERIALIZED);
+    Router concurrent(DispatchMode::CONCURRENT);
+    Static static_router;
+    serialized.get_add_processor()->register_impl("bench_add", count);
+    concurrent.get_add_processor()->register_impl("bench_add", count);
+    static_router.get_processor<OpAddMsg>()->register_impl("bench_add", count);
+
+    const OpAddMsg add("bench_add", "tensor_0", "tensor_1", "tensor_2");
+    std::deque<Static::MsgVariant> stream;
+    for (int i = 0; i < kStreamSize; ++i) {
+        if (i % 2 == 0) {
+            stream.emplace_back(std::in_place_type<OpAddMsg>, "bench_add", "tensor_0", "tensor_1", "tensor_2");
+        } else {
+            stream.emplace_back(std::in_place_type<OpMMAMsg>, "bench_mma", "a", "b", "c", "out");
+        }
+    }
+
+    double router_serial = ns_per_msg([&](int) { serialized.dispatch(add); });
+    double router_concurrent = ns_per_msg([&](int) { concurrent.dispatch(add); });
+    double static_typed = ns_per_msg([&](int) { static_router.dispatch(add); });
+    double router_stream = ns_per_msg([&](int i) {
+        std::visit([&](const auto& msg) { concurrent.dispatch(msg); }, stream[i % kStreamSize]);
+    });
+    double static_stream = ns_per_msg([&](int i) { static_router.dispatch(stream[i % kStreamSize]); });
+
+    std::printf("%-36s %-12s\n", "dispatch", "ns/msg");
+    std::printf("%-36s %-12.2f\n", "Router SERIALIZED (OpAdd)", router_serial);
+    std::printf("%-36s %-12.2f\n", "Router CONCURRENT (OpAdd)", router_concurrent);
+    std::printf("%-36s %-12.2f\n", "StaticRouter typed (OpAdd)", static_typed);
+    std::printf("%-36s %-12.2f\n", "Router CONCURRENT (variant stream)", router_stream);
+    std::printf("%-36s %-12.2f\n", "StaticRouter (variant stream)", static_stream);
+    std::printf("(handled %llu)\n", static_cast<unsigned long long>(handled));
+    return 0;
+}
@@ -0,0 +1,27 @@
+#pragma once
+#include <atomic>
+#include <cstdint>
+
+// 稠密类型ID：同一个Domain内的每个类型在首次使用时分配一个小整数（0、1、2...），之后不变
+// 分发表可以用ID直接索引数组，不需要typeid和哈希
+// 注意：计数器放在类模板的静态成员函数内（外部链接），多个动态库共享同一套编号
+template <typename Domain>
+class DenseTypeId {
+public:
+    template <typename T>
+    static uint32_t of() {
+        static const uint32_t id = counter().fetch_add(1, std::memory_order_relaxed);
+        return id;
+    }
+
+    // 已分配的ID个数
+    static uint32_t count() {
+        return counter().load(std::memory_order_relaxed);
+    }
+
+private:
+    static std::atomic<uint32_t>& counter() {
+        static std::atomic<uint32_t> next{0};
+        return next;
+    }
+};
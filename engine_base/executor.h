@@ -0,0 +1,85 @@
+#pragma once
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <mutex>
+#include "inline_function.h"
+#include "no_copy_move.h"
+
+// 执行器任务：内联可调用对象，提交任务本身不分配堆内存
+using ExecutorTask = InlineFunction<void()>;
+
+// 队列满时的背压策略
+enum class BackpressurePolicy {
+    BLOCK,       // 阻塞提交者直到有空位
+    REJECT,      // 立即拒绝，submit 返回false
+    CALLER_RUNS, // 在提交者线程直接执行
+};
+
+// 任务执行器接口：ApiBase/Router 通过它把处理工作转移到工作线程
+class Executor : public NoCopyMove {
+public:
+    virtual ~Executor() = default;
+
+    // 提交任务：返回false表示被拒绝，此时 task 未被移走，调用方仍持有它
+    virtual bool submit(ExecutorTask&& task) = 0;
+
+    // 等待所有已提交的任务执行完毕
+    virtual void drain() = 0;
+
+    virtual size_t worker_count() const = 0;
+};
+
+// 在途任务计数：执行器可能被多个使用方共享，各自只等待自己提交的任务
+// 计数只在持锁时归零，wait_idle() 返回后 finish() 不会再访问本对象，使用方可随即析构
+class PendingTasks : public NoCopyMove {
+public:
+    // 任务执行结束（含异常退出）时调用 finish()
+    class Scope {
+    public:
+        explicit Scope(PendingTasks& tasks) : tasks_(tasks) {}
+        ~Scope() { tasks_.finish(); }
+
+        Scope(const Scope&) = delete;
+        Scope& operator=(const Scope&) = delete;
+
+    private:
+        PendingTasks& tasks_;
+    };
+
+    // 提交前调用
+    void add() {
+        count_.fetch_add(1, std::memory_order_relaxed);
+    }
+
+    // 任务完成或提交被拒绝时调用
+    void finish() {
+        size_t count = count_.load(std::memory_order_relaxed);
+        while (count > 1) {
+            if (count_.compare_exchange_weak(count, count - 1, std::memory_order_acq_rel,
+                                             std::memory_order_relaxed)) {
+                return;
+            }
+        }
+        // 可能是最后一个：持锁递减并唤醒，等待方只能在本线程释放锁之后看到归零
+        std::lock_guard<std::mutex> lock(mutex_);
+        if (count_.fetch_sub(1, std::memory_order_acq_rel) == 1) {
+            idle_cv_.notify_all();
+        }
+    }
+
+    // 等待本使用方提交的任务全部完成
+    void wait_idle() {
+        std::unique_lock<std::mutex> lock(mutex_);
+        idle_cv_.wait(lock, [this]() { return count_.load(std::memory_order_acquire) == 0; });
+    }
+
+    size_t pending() const {
+        return count_.load(std::memory_order_relaxed);
+    }
+
+private:
+    std::atomic<size_t> count_{0};
+    std::mutex mutex_;
+    std::condition_variable idle_cv_;
+};
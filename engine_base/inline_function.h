@@ -0,0 +1,105 @@
+#pragma once
+#include <cstddef>
+#include <new>
+#include <type_traits>
+#include <utility>
+
+// 默认内联容量：足以容纳捕获this+成员函数指针的lambda，或包装一个std::function
+constexpr size_t kInlineFunctionCapacity = 32;
+
+template <typename Signature, size_t Capacity = kInlineFunctionCapacity>
+class InlineFunction;
+
+// 仅可移动、固定容量的内联可调用对象（替代std::function）
+// 可调用对象直接构造在内部缓冲区中，永不分配堆内存；超过容量在编译期报错
+// 调用只经过一次函数指针间接跳转
+template <typename R, typename... Args, size_t Capacity>
+class InlineFunction<R(Args...), Capacity> {
+public:
+    InlineFunction() noexcept = default;
+    InlineFunction(std::nullptr_t) noexcept {}
+
+    template <typename F,
+              typename D = std::decay_t<F>,
+              typename = std::enable_if_t<!std::is_same_v<D, InlineFunction> &&
+                                          std::is_invocable_r_v<R, D&, Args...>>>
+    InlineFunction(F&& f) {
+        static_assert(sizeof(D) <= Capacity, "callable too large for InlineFunction, increase Capacity");
+        static_assert(alignof(D) <= alignof(std::max_align_t), "callable over-aligned for InlineFunction");
+        static_assert(std::is_nothrow_move_constructible_v<D>, "callable must be nothrow move constructible");
+        ::new (static_cast<void*>(storage_)) D(std::forward<F>(f));
+        invoke_ = &invoke_impl<D>;
+        manage_ = &manage_impl<D>;
+    }
+
+    InlineFunction(InlineFunction&& other) noexcept {
+        move_from(other);
+    }
+
+    InlineFunction& operator=(InlineFunction&& other) noexcept {
+        if (this != &other) {
+            reset();
+            move_from(other);
+        }
+        return *this;
+    }
+
+    InlineFunction& operator=(std::nullptr_t) noexcept {
+        reset();
+        return *this;
+    }
+
+    InlineFunction(const InlineFunction&) = delete;
+    InlineFunction& operator=(const InlineFunction&) = delete;
+
+    ~InlineFunction() {
+        reset();
+    }
+
+    explicit operator bool() const noexcept {
+        return invoke_ != nullptr;
+    }
+
+    // 与std::function一致：const调用，内部可调用对象按非const调用
+    R operator()(Args... args) const {
+        return invoke_(const_cast<unsigned char*>(storage_), std::forward<Args>(args)...);
+    }
+
+private:
+    enum class Op { MOVE, DESTROY };
+
+    template <typename D>
+    static R invoke_impl(void* storage, Args&&... args) {
+        return (*static_cast<D*>(storage))(std::forward<Args>(args)...);
+    }
+
+    template <typename D>
+    static void manage_impl(Op op, void* dst, void* src) {
+        if (op == Op::MOVE) {
+            ::new (dst) D(std::move(*static_cast<D*>(src)));
+        }
+        static_cast<D*>(src)->~D();
+    }
+
+    void move_from(InlineFunction& other) noexcept {
+        if (other.invoke_ != nullptr) {
+            other.manage_(Op::MOVE, storage_, other.storage_);
+            invoke_ = other.invoke_;
+            manage_ = other.manage_;
+            other.invoke_ = nullptr;
+            other.manage_ = nullptr;
+        }
+    }
+
+    void reset() noexcept {
+        if (invoke_ != nullptr) {
+            manage_(Op::DESTROY, nullptr, storage_);
+            invoke_ = nullptr;
+            manage_ = nullptr;
+        }
+    }
+
+    alignas(std::max_align_t) unsigned char storage_[Capacity];
+    R (*invoke_)(void*, Args&&...) = nullptr;
+    void (*manage_)(Op, void*, void*) = nullptr;
+};
@@ -0,0 +1,110 @@
+#pragma once
+#include <algorithm>
+#include <cstddef>
+#include <memory>
+#include <mutex>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+// 按类型的对象池：每个线程缓存一批回收的对象，超出上限时整批归还到全局仓库，
+// 本线程缓存为空时再从仓库整批取回（生产者/消费者分处不同线程时对象也能循环使用）
+// 回收的对象不析构，保留字符串/数组已有的容量；再次取出时通过 assign() 重新赋值，
+// 稳态下构造一个事件不再分配堆内存
+// T 需提供与构造函数参数对应的 assign(...)；传入单个 T 时改为赋值
+template <typename T, size_t CacheSize = 256>
+class ObjectPool {
+public:
+    struct Recycler {
+        void operator()(T* obj) const { ObjectPool::recycle(obj); }
+    };
+    using Ptr = std::unique_ptr<T, Recycler>;
+
+    template <typename... Args>
+    static Ptr make(Args&&... args) {
+        T* obj = acquire();
+        if (obj == nullptr) {
+            return Ptr(new T(std::forward<Args>(args)...));
+        }
+        if constexpr (is_self<Args...>()) {
+            *obj = (std::forward<Args>(args), ...);
+        } else {
+            obj->assign(std::forward<Args>(args)...);
+        }
+        return Ptr(obj);
+    }
+
+    // 当前线程缓存的对象数（统计/测试用）
+    static size_t cached() { return local().objects.size(); }
+
+private:
+    static constexpr size_t kBatch = CacheSize / 2 == 0 ? 1 : CacheSize / 2;
+    static constexpr size_t kDepotLimit = CacheSize * 64;
+
+    template <typename... Args>
+    static constexpr bool is_self() {
+        if constexpr (sizeof...(Args) == 1) {
+            return (std::is_same_v<std::decay_t<Args>, T> && ...);
+        } else {
+            return false;
+        }
+    }
+
+    struct FreeList {
+        std::vector<T*> objects;
+        ~FreeList() {
+            for (T* obj : objects) {
+                delete obj;
+            }
+        }
+    };
+
+    // 全局仓库：只在线程缓存满/空时整批访问
+    struct Depot {
+        std::mutex mutex;
+        FreeList list;
+    };
+
+    static FreeList& local() {
+        thread_local FreeList list;
+        return list;
+    }
+
+    static Depot& depot() {
+        static Depot depot;
+        return depot;
+    }
+
+    static T* acquire() {
+        FreeList& list = local();
+        if (list.objects.empty()) {
+            Depot& shared = depot();
+            std::lock_guard<std::mutex> lock(shared.mutex);
+            const size_t n = std::min(kBatch, shared.list.objects.size());
+            list.objects.insert(list.objects.end(), shared.list.objects.end() - n, shared.list.objects.end());
+            shared.list.objects.resize(shared.list.objects.size() - n);
+        }
+        if (list.objects.empty()) {
+            return nullptr;
+        }
+        T* obj = list.objects.back();
+        list.objects.pop_back();
+        return obj;
+    }
+
+    static void recycle(T* obj) {
+        FreeList& list = local();
+        if (list.objects.size() >= CacheSize) {
+            Depot& shared = depot();
+            std::lock_guard<std::mutex> lock(shared.mutex);
+            if (shared.list.objects.size() < kDepotLimit) {
+                shared.list.objects.insert(shared.list.objects.end(), list.objects.end() - kBatch, list.objects.end());
+            } else {
+                // 仓库已满：释放这一批，池占用的内存有上限
+                std::for_each(list.objects.end() - kBatch, list.objects.end(), [](T* p) { delete p; });
+            }
+            list.objects.resize(list.objects.size() - kBatch);
+        }
+        list.objects.push_back(obj);
+    }
+};
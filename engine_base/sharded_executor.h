@@ -0,0 +1,51 @@
+#pragma once
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <vector>
+#include "executor.h"
+#include "thread_pool.h"
+
+// 按键分片的执行器（分区actor模型）：N条单线程通道，每条通道一个无锁有界队列
+// 相同键的任务总是进入同一通道，按提交顺序依次执行；不同键分散到各通道并行执行
+// 通道固定使用 BLOCK 背压：拒绝或在调用线程执行都会打乱同键顺序
+class ShardedExecutor : public Executor {
+public:
+    explicit ShardedExecutor(size_t lanes, size_t lane_capacity = 1024) {
+        if (lanes == 0) {
+            lanes = 1;
+        }
+        for (size_t i = 0; i < lanes; ++i) {
+            lanes_.push_back(std::make_unique<ThreadPool>(1, lane_capacity, BackpressurePolicy::BLOCK));
+        }
+    }
+
+    // 按键提交：同键保序
+    bool submit(uint64_t key, ExecutorTask&& task) {
+        return lanes_[lane_of(key)]->submit(std::move(task));
+    }
+
+    // 无键提交：轮转分发，不保证任何顺序
+    bool submit(ExecutorTask&& task) override {
+        const size_t lane = next_.fetch_add(1, std::memory_order_relaxed) % lanes_.size();
+        return lanes_[lane]->submit(std::move(task));
+    }
+
+    void drain() override {
+        for (auto& lane : lanes_) {
+            lane->drain();
+        }
+    }
+
+    size_t worker_count() const override { return lanes_.size(); }
+
+    // 键到通道的映射：先做乘法散列，连续的键（如驻留符号ID）也能均匀分布
+    size_t lane_of(uint64_t key) const {
+        return static_cast<size_t>((key * 0x9E3779B97F4A7C15ull) >> 32) % lanes_.size();
+    }
+
+private:
+    std::vector<std::unique_ptr<ThreadPool>> lanes_;
+    std::atomic<size_t> next_{0};
+};
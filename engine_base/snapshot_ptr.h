@@ -0,0 +1,57 @@
+#pragma once
+#include <atomic>
+#include <memory>
+#include <vector>
+#include "no_copy_move.h"
+
+// 读多写少的不可变快照指针（RCU风格）
+// 读者：在外部读者计数保护下 load() 得到当前快照，整个使用期间无锁、无拷贝
+// 写者（外部串行化）：基于 current() 复制出新快照后 publish()，旧快照进入退休列表，
+//       确认没有活跃读者后调用 reclaim() 回收；或每过一个宽限期调用 advance() 逐代回收
+// 读者计数由使用方维护：读者先递增计数再 load()，两者均为 seq_cst；
+// 写者 publish() 之后观察到计数为0，说明之前的读者都已退出、之后的读者只能看到新快照
+template <typename T>
+class SnapshotPtr : public NoCopyMove {
+public:
+    SnapshotPtr() : current_(new T()) {}
+
+    ~SnapshotPtr() {
+        delete current_.load(std::memory_order_relaxed);
+    }
+
+    // 读者：返回当前快照（调用方必须已登记为活跃读者）
+    const T* load() const {
+        return current_.load(std::memory_order_seq_cst);
+    }
+
+    // 写者：当前快照（写者之间已串行化，直接读取）
+    const T& current() const {
+        return *current_.load(std::memory_order_relaxed);
+    }
+
+    // 写者：发布新快照，旧快照退休
+    void publish(std::unique_ptr<T> next) {
+        T* old = current_.exchange(next.release(), std::memory_order_seq_cst);
+        retired_.emplace_back(old);
+    }
+
+    // 写者：回收所有退休快照（调用方须确认此刻没有活跃读者）
+    void reclaim() {
+        retired_.clear();
+        pending_.clear();
+    }
+
+    // 写者：一个宽限期结束（上一代退休之前进入的读者都已退出）时调用，
+    // 回收上一代退休快照，本代退休快照转为等待下一个宽限期
+    void advance() {
+        pending_ = std::move(retired_);
+        retired_.clear();
+    }
+
+    size_t retired_count() const { return retired_.size() + pending_.size(); }
+
+private:
+    std::atomic<T*> current_;
+    std::vector<std::unique_ptr<T>> retired_;  // 本代退休
+    std::vector<std::unique_ptr<T>> pending_;  // 上一代退休，等待宽限期结束
+};
@@ -0,0 +1,134 @@
+#pragma once
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <memory>
+#include "no_copy_move.h"
+
+// 单生产者单消费者变长字节环（无锁）
+// 记录布局：[uint32 长度][负载]，按8字节对齐；尾部放不下时写入回绕标记后从头开始
+// 生产者：reserve() -> 填充负载 -> commit()；消费者：peek() -> 读取负载 -> release()
+class SpscByteRing : public NoCopyMove {
+public:
+    explicit SpscByteRing(size_t capacity)
+        : capacity_(round_up_pow2(capacity)),
+          mask_(capacity_ - 1),
+          buffer_(new uint8_t[capacity_]) {
+        // 预先触碰全部页面，避免热路径上的缺页中断
+        std::memset(buffer_.get(), 0, capacity_);
+    }
+
+    // 预留n字节负载空间，空间不足返回nullptr（不阻塞）
+    uint8_t* reserve(size_t n) {
+        const size_t need = align8(kHeaderSize + n);
+        const size_t pos = tail_.load(std::memory_order_relaxed);
+        const size_t idx = pos & mask_;
+        const size_t contiguous = capacity_ - idx;
+        const size_t total = need <= contiguous ? need : contiguous + need;
+
+        if (total > capacity_) {
+            return nullptr;
+        }
+        if (capacity_ - (pos - cached_head_) < total) {
+            cached_head_ = head_.load(std::memory_order_acquire);
+            if (capacity_ - (pos - cached_head_) < total) {
+                return nullptr; // 满
+            }
+        }
+
+        size_t record = idx;
+        if (need > contiguous) {
+            write_header(idx, kWrapMarker);
+            record = 0;
+        }
+        write_header(record, static_cast<uint32_t>(n));
+        pending_tail_ = pos + total;
+        return buffer_.get() + record + kHeaderSize;
+    }
+
+    // 发布最近一次reserve的记录
+    void commit() {
+        tail_.store(pending_tail_, std::memory_order_release);
+    }
+
+    // 查看队首记录，为空返回nullptr
+    const uint8_t* peek(size_t& n) {
+        size_t pos = head_.load(std::memory_order_relaxed);
+        const size_t tail = tail_.load(std::memory_order_acquire);
+        if (pos == tail) {
+            return nullptr;
+        }
+        size_t idx = pos & mask_;
+        uint32_t len = read_header(idx);
+        if (len == kWrapMarker) {
+            pos += capacity_ - idx;
+            idx = 0;
+            len = read_header(0);
+        }
+        n = len;
+        pending_head_ = pos + align8(kHeaderSize + len);
+        return buffer_.get() + idx + kHeaderSize;
+    }
+
+    // 释放最近一次peek的记录
+    void release() {
+        head_.store(pending_head_, std::memory_order_release);
+    }
+
+    // 生产者已发布的写位置（单调递增，记录边界）：消费者可据此限定本轮只读到该位置
+    size_t write_position() const {
+        return tail_.load(std::memory_order_acquire);
+    }
+
+    // 消费者当前读位置（仅消费者调用）
+    size_t read_position() const {
+        return head_.load(std::memory_order_relaxed);
+    }
+
+    bool empty() const {
+        return head_.load(std::memory_order_acquire) == tail_.load(std::memory_order_acquire);
+    }
+
+    // 已占用字节数（并发时仅供统计）
+    size_t used_approx() const {
+        return tail_.load(std::memory_order_relaxed) - head_.load(std::memory_order_relaxed);
+    }
+
+    size_t capacity() const { return capacity_; }
+
+private:
+    static constexpr size_t kHeaderSize = sizeof(uint32_t);
+    static constexpr uint32_t kWrapMarker = 0xFFFFFFFFu;
+
+    static size_t round_up_pow2(size_t n) {
+        size_t v = 64;
+        while (v < n) v <<= 1;
+        return v;
+    }
+
+    static size_t align8(size_t n) { return (n + 7) & ~static_cast<size_t>(7); }
+
+    void write_header(size_t idx, uint32_t value) {
+        std::memcpy(buffer_.get() + idx, &value, sizeof(value));
+    }
+
+    uint32_t read_header(size_t idx) const {
+        uint32_t value;
+        std::memcpy(&value, buffer_.get() + idx, sizeof(value));
+        return value;
+    }
+
+    const size_t capacity_;
+    const size_t mask_;
+    std::unique_ptr<uint8_t[]> buffer_;
+
+    // 生产者独占
+    alignas(64) std::atomic<size_t> tail_{0};
+    size_t pending_tail_ = 0;
+    size_t cached_head_ = 0;
+
+    // 消费者独占
+    alignas(64) std::atomic<size_t> head_{0};
+    size_t pending_head_ = 0;
+};
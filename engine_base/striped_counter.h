@@ -0,0 +1,87 @@
+#pragma once
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include "no_copy_move.h"
+
+// 分条计数器（读者计数）：每个线程固定映射到一个独占缓存行的计数槽
+// 进入/退出只修改本线程的槽，多核并发时不再争用同一缓存行；同一次进入与退出必须使用同一个槽
+// 判断是否为零需要遍历所有槽，只用于写者/析构等冷路径
+// 每个槽独立满足"进入先于退出"，逐槽读取为零即说明当时该槽上的读者都已退出
+class StripedCounter : public NoCopyMove {
+public:
+    static constexpr size_t kStripes = 64;
+
+    using Slot = std::atomic<int64_t>;
+
+    // 进入：返回本次使用的槽，退出时传回
+    Slot& enter() {
+        Slot& slot = stripes_[thread_stripe()].count;
+        slot.fetch_add(1, std::memory_order_seq_cst);
+        return slot;
+    }
+
+    static void leave(Slot& slot) {
+        slot.fetch_sub(1, std::memory_order_seq_cst);
+    }
+
+    bool is_zero() const {
+        for (const Stripe& stripe : stripes_) {
+            if (stripe.count.load(std::memory_order_seq_cst) != 0) {
+                return false;
+            }
+        }
+        return true;
+    }
+
+private:
+    // 线程首次使用时轮转分配槽下标
+    static size_t thread_stripe() {
+        static std::atomic<size_t> next{0};
+        thread_local const size_t index = next.fetch_add(1, std::memory_order_relaxed) % kStripes;
+        return index;
+    }
+
+    struct alignas(64) Stripe {
+        Slot count{0};
+    };
+
+    Stripe stripes_[kStripes];
+};
+
+// 带宽限期的读者计数：两组分条计数器按纪元奇偶轮换
+// 读者进入时登记到当前纪元对应的一组；写者翻转纪元后，旧一组只会减少（除进入前读到旧纪元的迟到者，
+// 它们在翻转之后才读取快照，看不到翻转前退休的对象），归零即说明翻转前进入的读者都已退出
+// 写者（外部串行化）每次退休对象后调用 try_advance()：上一组归零时翻转纪元并返回 true，
+// 此时上一次翻转之前退休的对象可以回收；持续有读者时也能逐代回收，不必等待全部读者为零
+class GracePeriodCounter : public NoCopyMove {
+public:
+    using Slot = StripedCounter::Slot;
+
+    Slot& enter() {
+        const uint64_t epoch = epoch_.load(std::memory_order_seq_cst);
+        return counters_[epoch & 1].enter();
+    }
+
+    static void leave(Slot& slot) {
+        StripedCounter::leave(slot);
+    }
+
+    bool is_zero() const {
+        return counters_[0].is_zero() && counters_[1].is_zero();
+    }
+
+    // 写者：上一纪元的读者都已退出时翻转纪元
+    bool try_advance() {
+        const uint64_t epoch = epoch_.load(std::memory_order_relaxed);
+        if (!counters_[(epoch + 1) & 1].is_zero()) {
+            return false;
+        }
+        epoch_.store(epoch + 1, std::memory_order_seq_cst);
+        return true;
+    }
+
+private:
+    std::atomic<uint64_t> epoch_{0};
+    StripedCounter counters_[2];
+};
@@ -0,0 +1,155 @@
+#pragma once
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include "no_copy_move.h"
+
+// 全局字符串驻留表（无锁）：相同内容的字符串映射到同一个紧凑ID，驻留后的字符串到进程退出前一直有效
+// 开放寻址哈希表，槽位保存符号ID（0为空），插入通过CAS抢占空槽；
+// 字符串条目按块追加存储、从不移动，读取不加锁
+// 两个线程同时插入同一个新字符串时，落败方预先分配的ID被丢弃（只浪费一个ID，不影响正确性）
+// 驻留的字符串永不释放、总数有上限：只用于有限的名字集合（如实现名），不要驻留按消息生成的名字
+class SymbolTable : public NoCopyMove {
+public:
+    static constexpr size_t kSlots = size_t(1) << 20;
+    static constexpr size_t kMaxSymbols = kSlots / 4 * 3; // 装载因子上限0.75
+    static constexpr size_t kChunkSize = 4096;
+
+    // 平凡析构：驻留字符串在其他静态对象析构期间仍可安全使用
+    static SymbolTable& global() {
+        static SymbolTable table;
+        return table;
+    }
+
+    // 返回字符串的符号ID；空字符串固定为0
+    // 表满时抛出 std::length_error，已驻留的字符串仍可正常查找
+    uint32_t intern(std::string_view text) {
+        if (text.empty()) {
+            return 0;
+        }
+        const size_t hash = std::hash<std::string_view>{}(text);
+        uint32_t candidate = 0;
+        for (size_t i = hash & (kSlots - 1);; i = (i + 1) & (kSlots - 1)) {
+            uint32_t id = slots_[i].load(std::memory_order_acquire);
+            if (id == 0) {
+                if (candidate == 0) {
+                    candidate = create(text, hash);
+                }
+                if (slots_[i].compare_exchange_strong(id, candidate, std::memory_order_acq_rel,
+                                                      std::memory_order_acquire)) {
+                    return candidate;
+                }
+                // 槽位被其他线程抢先占用，id 为对方写入的符号，继续比较
+            }
+            const Entry& entry = entry_of(id);
+            if (entry.hash == hash && entry.text == text) {
+                return id;
+            }
+        }
+    }
+
+    // 只查找不插入：未驻留时返回0
+    uint32_t find(std::string_view text) const {
+        if (text.empty()) {
+            return 0;
+        }
+        const size_t hash = std::hash<std::string_view>{}(text);
+        for (size_t i = hash & (kSlots - 1);; i = (i + 1) & (kSlots - 1)) {
+            const uint32_t id = slots_[i].load(std::memory_order_acquire);
+            if (id == 0) {
+                return 0;
+            }
+            const Entry& entry = entry_of(id);
+            if (entry.hash == hash && entry.text == text) {
+                return id;
+            }
+        }
+    }
+
+    const std::string& text(uint32_t id) const {
+        static const std::string empty;
+        return id == 0 ? empty : entry_of(id).text;
+    }
+
+    // 已分配的符号数（含空字符串）
+    size_t size() const { return next_id_.load(std::memory_order_relaxed); }
+
+private:
+    struct Entry {
+        std::string text;
+        size_t hash = 0;
+    };
+
+    uint32_t create(std::string_view text, size_t hash) {
+        // 表满后不再推进 next_id_，避免ID越界回绕覆盖已有条目
+        uint32_t id = next_id_.load(std::memory_order_relaxed);
+        do {
+            if (id >= kMaxSymbols) {
+                throw std::length_error("SymbolTable capacity exceeded");
+            }
+        } while (!next_id_.compare_exchange_weak(id, id + 1, std::memory_order_relaxed));
+        std::atomic<Entry*>& chunk = chunks_[id / kChunkSize];
+        Entry* entries = chunk.load(std::memory_order_acquire);
+        if (entries == nullptr) {
+            Entry* fresh = new Entry[kChunkSize];
+            if (chunk.compare_exchange_strong(entries, fresh, std::memory_order_acq_rel,
+                                              std::memory_order_acquire)) {
+                entries = fresh;
+            } else {
+                delete[] fresh;
+            }
+        }
+        // 条目在写入槽位（release）之前填好，读者经槽位（acquire）拿到ID后可见
+        Entry& entry = entries[id % kChunkSize];
+        entry.text.assign(text.data(), text.size());
+        entry.hash = hash;
+        return id;
+    }
+
+    const Entry& entry_of(uint32_t id) const {
+        return chunks_[id / kChunkSize].load(std::memory_order_acquire)[id % kChunkSize];
+    }
+
+    std::atomic<uint32_t> slots_[kSlots];
+    std::atomic<Entry*> chunks_[kMaxSymbols / kChunkSize + 1];
+    std::atomic<uint32_t> next_id_{1};
+};
+
+// 驻留字符串的句柄：4字节，比较/哈希都是整数运算
+// 由字符串显式构造时驻留（插入），lookup() 只查找；str() 返回驻留表中的字符串
+class Symbol {
+public:
+    constexpr Symbol() noexcept = default;
+    explicit Symbol(std::string_view text) : id_(SymbolTable::global().intern(text)) {}
+    explicit Symbol(const char* text) : Symbol(std::string_view(text)) {}
+    explicit Symbol(const std::string& text) : Symbol(std::string_view(text)) {}
+
+    // 只查找已驻留的符号，不插入；未驻留时返回空符号
+    static Symbol lookup(std::string_view text) {
+        Symbol symbol;
+        symbol.id_ = SymbolTable::global().find(text);
+        return symbol;
+    }
+
+    uint32_t id() const noexcept { return id_; }
+    const std::string& str() const { return SymbolTable::global().text(id_); }
+    bool empty() const noexcept { return id_ == 0; }
+
+    friend bool operator==(Symbol a, Symbol b) noexcept { return a.id_ == b.id_; }
+    friend bool operator!=(Symbol a, Symbol b) noexcept { return a.id_ != b.id_; }
+    friend bool operator<(Symbol a, Symbol b) noexcept { return a.id_ < b.id_; }
+
+private:
+    uint32_t id_ = 0;
+};
+
+namespace std {
+template <>
+struct hash<Symbol> {
+    size_t operator()(Symbol symbol) const noexcept { return symbol.id(); }
+};
+} // namespace std
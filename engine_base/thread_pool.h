@@ -0,0 +1,119 @@
+#pragma once
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <mutex>
+#include <thread>
+#include <vector>
+#include "bounded_queue.h"
+#include "executor.h"
+
+// 固定大小工作线程池：所有线程共享一个有界MPMC任务队列
+// 提交路径无锁；只有存在休眠的工作线程时才加锁唤醒
+class ThreadPool : public Executor {
+public:
+    explicit ThreadPool(size_t workers, size_t queue_capacity = 1024,
+                        BackpressurePolicy policy = BackpressurePolicy::BLOCK)
+        : queue_(queue_capacity), policy_(policy) {
+        if (workers == 0) {
+            workers = 1;
+        }
+        for (size_t i = 0; i < workers; ++i) {
+            workers_.emplace_back([this]() { worker_loop(); });
+        }
+    }
+
+    // 析构时先执行完队列中剩余任务再退出
+    ~ThreadPool() override {
+        drain();
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            stopping_ = true;
+        }
+        work_cv_.notify_all();
+        for (auto& t : workers_) {
+            t.join();
+        }
+    }
+
+    bool submit(ExecutorTask&& task) override {
+        outstanding_.fetch_add(1, std::memory_order_relaxed);
+        while (!queue_.try_push(std::move(task))) {
+            if (policy_ == BackpressurePolicy::REJECT) {
+                finish_one();
+                return false;
+            }
+            if (policy_ == BackpressurePolicy::CALLER_RUNS) {
+                run(task);
+                return true;
+            }
+            std::this_thread::yield();
+        }
+        // 与工作线程休眠前的检查配对：要么这里看到休眠者，要么对方看到新任务
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        if (sleepers_.load(std::memory_order_relaxed) > 0) {
+            std::lock_guard<std::mutex> lock(mutex_);
+            work_cv_.notify_one();
+        }
+        return true;
+    }
+
+    void drain() override {
+        std::unique_lock<std::mutex> lock(mutex_);
+        idle_cv_.wait(lock, [this]() {
+            return outstanding_.load(std::memory_order_acquire) == 0;
+        });
+    }
+
+    size_t worker_count() const override { return workers_.size(); }
+
+    BackpressurePolicy policy() const { return policy_; }
+
+private:
+    void worker_loop() {
+        ExecutorTask task;
+        for (;;) {
+            if (queue_.try_pop(task)) {
+                run(task);
+                continue;
+            }
+            std::unique_lock<std::mutex> lock(mutex_);
+            sleepers_.fetch_add(1, std::memory_order_relaxed);
+            std::atomic_thread_fence(std::memory_order_seq_cst);
+            work_cv_.wait(lock, [this]() { return stopping_ || !queue_.empty_approx(); });
+            sleepers_.fetch_sub(1, std::memory_order_relaxed);
+            if (stopping_ && queue_.empty_approx()) {
+                return;
+            }
+        }
+    }
+
+    void run(ExecutorTask& task) {
+        try {
+            task();
+        } catch (...) {
+            // 任务自行负责错误上报，异常不能终止工作线程
+        }
+        task = nullptr;
+        finish_one();
+    }
+
+    // 最后一个未完成任务结束时唤醒 drain()
+    void finish_one() {
+        if (outstanding_.fetch_sub(1, std::memory_order_acq_rel) == 1) {
+            std::lock_guard<std::mutex> lock(mutex_);
+            idle_cv_.notify_all();
+        }
+    }
+
+    BoundedMPMCQueue<ExecutorTask> queue_;
+    const BackpressurePolicy policy_;
+    std::vector<std::thread> workers_;
+
+    std::atomic<size_t> outstanding_{0}; // 已提交未完成的任务数
+    std::atomic<int> sleepers_{0};       // 休眠中的工作线程数
+    std::mutex mutex_;
+    std::condition_variable work_cv_;
+    std::condition_variable idle_cv_;
+    bool stopping_ = false;
+};
@@ -0,0 +1,187 @@
+#pragma once
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+#include "bounded_queue.h"
+#include "executor.h"
+
+// 工作窃取执行器：每个工作线程一个预分配的有界无锁队列（BoundedMPMCQueue），入队与出队都不加锁、不分配堆内存
+// 工作线程内提交的任务优先进入自己的队列；外部提交按轮转分发到各队列；目标队列满时依次落到其他队列
+// 本地队列为空时随机选择其他队列窃取；本地与窃取都按FIFO取出最早提交的任务
+// 处理代价差异大时（廉价事件夹杂昂贵事件），空闲线程主动分担积压，不再争用单个共享队列
+class WorkStealingExecutor : public Executor {
+public:
+    explicit WorkStealingExecutor(size_t workers, size_t capacity = 4096,
+                                  BackpressurePolicy policy = BackpressurePolicy::BLOCK)
+        : capacity_(capacity == 0 ? 1 : capacity), policy_(policy) {
+        if (workers == 0) {
+            workers = 1;
+        }
+        // 各队列合计至少容纳 capacity_ 个任务：queued_ 名额不超过总容量时总有队列有空位
+        const size_t per_queue = (capacity_ + workers - 1) / workers;
+        for (size_t i = 0; i < workers; ++i) {
+            queues_.push_back(std::make_unique<BoundedMPMCQueue<ExecutorTask>>(per_queue));
+        }
+        for (size_t i = 0; i < workers; ++i) {
+            workers_.emplace_back([this, i]() { worker_loop(i); });
+        }
+    }
+
+    // 析构时先执行完所有剩余任务再退出
+    ~WorkStealingExecutor() override {
+        drain();
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            stopping_ = true;
+        }
+        work_cv_.notify_all();
+        for (auto& t : workers_) {
+            t.join();
+        }
+    }
+
+    bool submit(ExecutorTask&& task) override {
+        const WorkerSlot& self = current_worker();
+        // 先占用容量名额，超出容量时按背压策略处理
+        while (queued_.fetch_add(1, std::memory_order_seq_cst) >= capacity_) {
+            queued_.fetch_sub(1, std::memory_order_relaxed);
+            if (policy_ == BackpressurePolicy::REJECT) {
+                return false;
+            }
+            // 工作线程内提交不阻塞：所有工作线程都阻塞在提交上会互相等待
+            if (policy_ == BackpressurePolicy::CALLER_RUNS || self.owner == this) {
+                outstanding_.fetch_add(1, std::memory_order_relaxed);
+                run(task);
+                return true;
+            }
+            std::this_thread::yield();
+        }
+        outstanding_.fetch_add(1, std::memory_order_relaxed);
+
+        const size_t n = queues_.size();
+        size_t target = self.owner == this
+            ? self.index
+            : next_queue_.fetch_add(1, std::memory_order_relaxed) % n;
+        // 已占到名额，必有队列有空位；出队方尚未释放槽位时可能短暂看到满，换下一个队列重试
+        const size_t first = target;
+        while (!queues_[target]->try_push(std::move(task))) {
+            target = (target + 1) % n;
+            if (target == first) {
+                std::this_thread::yield();
+            }
+        }
+
+        // 与工作线程休眠前的检查配对：要么这里看到休眠者，要么对方看到 queued_ 增加
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        if (sleepers_.load(std::memory_order_relaxed) > 0) {
+            std::lock_guard<std::mutex> lock(mutex_);
+            work_cv_.notify_one();
+        }
+        return true;
+    }
+
+    void drain() override {
+        std::unique_lock<std::mutex> lock(mutex_);
+        idle_cv_.wait(lock, [this]() {
+            return outstanding_.load(std::memory_order_acquire) == 0;
+        });
+    }
+
+    size_t worker_count() const override { return workers_.size(); }
+
+    // 统计：被其他线程窃取执行的任务数
+    uint64_t steal_count() const { return steals_.load(std::memory_order_relaxed); }
+
+private:
+    // 当前线程所属的执行器及工作线程下标
+    struct WorkerSlot {
+        const WorkStealingExecutor* owner = nullptr;
+        size_t index = 0;
+    };
+
+    static WorkerSlot& current_worker() {
+        thread_local WorkerSlot slot;
+        return slot;
+    }
+
+    void worker_loop(size_t index) {
+        current_worker() = WorkerSlot{this, index};
+        uint64_t rng = 0x9E3779B97F4A7C15ull * (index + 1);
+        ExecutorTask task;
+        for (;;) {
+            if (pop_local(index, task) || steal(index, rng, task)) {
+                queued_.fetch_sub(1, std::memory_order_relaxed);
+                run(task);
+                continue;
+            }
+            std::unique_lock<std::mutex> lock(mutex_);
+            sleepers_.fetch_add(1, std::memory_order_relaxed);
+            std::atomic_thread_fence(std::memory_order_seq_cst);
+            work_cv_.wait(lock, [this]() {
+                return stopping_ || queued_.load(std::memory_order_relaxed) > 0;
+            });
+            sleepers_.fetch_sub(1, std::memory_order_relaxed);
+            if (stopping_ && queued_.load(std::memory_order_relaxed) == 0) {
+                return;
+            }
+        }
+    }
+
+    // 本地队列
+    bool pop_local(size_t index, ExecutorTask& task) {
+        return queues_[index]->try_pop(task);
+    }
+
+    // 随机起点依次尝试其他队列
+    bool steal(size_t index, uint64_t& rng, ExecutorTask& task) {
+        const size_t n = queues_.size();
+        rng ^= rng << 13;
+        rng ^= rng >> 7;
+        rng ^= rng << 17;
+        const size_t start = static_cast<size_t>(rng % n);
+        for (size_t k = 0; k < n; ++k) {
+            const size_t victim = (start + k) % n;
+            if (victim == index) {
+                continue;
+            }
+            if (queues_[victim]->try_pop(task)) {
+                steals_.fetch_add(1, std::memory_order_relaxed);
+                return true;
+            }
+        }
+        return false;
+    }
+
+    void run(ExecutorTask& task) {
+        try {
+            task();
+        } catch (...) {
+            // 任务自行负责错误上报，异常不能终止工作线程
+        }
+        task = nullptr;
+        if (outstanding_.fetch_sub(1, std::memory_order_acq_rel) == 1) {
+            std::lock_guard<std::mutex> lock(mutex_);
+            idle_cv_.notify_all();
+        }
+    }
+
+    const size_t capacity_;
+    const BackpressurePolicy policy_;
+    std::vector<std::unique_ptr<BoundedMPMCQueue<ExecutorTask>>> queues_;
+    std::vector<std::thread> workers_;
+
+    std::atomic<size_t> queued_{0};      // 已入队未取出的任务数（含已占用的容量名额）
+    std::atomic<size_t> outstanding_{0}; // 已提交未完成的任务数
+    std::atomic<size_t> next_queue_{0};  // 外部提交的轮转下标
+    std::atomic<uint64_t> steals_{0};
+    std::atomic<int> sleepers_{0};
+    std::mutex mutex_;
+    std::condition_variable work_cv_;
+    std::condition_variable idle_cv_;
+    bool stopping_ = false;
+};
@@ -1,20 +1,34 @@
 #pragma once
 #include <string>
+#include <string_view>
 #include <vector>
 #include <mutex>
 #include <memory>
 #include <unordered_map>
-#include <functional>
 #include <typeindex>
+#include <type_traits>
 #include <atomic>
 #include <thread>
+#include <chrono>
 #include <condition_variable>
+#include <future>
 #include "../common/log.h"
 #include "../../engine_base/no_copy_move.h"
+#include "../../engine_base/snapshot_ptr.h"
+#include "../../engine_base/striped_counter.h"
+#include "../../engine_base/dense_type_id.h"
+#include "../../engine_base/inline_function.h"
+#include "../../engine_base/span.h"
+#include "../../engine_base/object_pool.h"
+#include "../../engine_base/symbol.h"
+#include "../../engine_base/thread_pool.h"
 
 namespace proj {
 namespace event {
 
+// 事件类型ID域
+struct EventIdDomain {};
+
 // CRTP事件基类
 template <typename Derived>
 class Event {
@@ -23,21 +37,36 @@ public:
         return typeid(Derived);
     }
 
+    // 稠密类型ID：分发表按此下标直接索引
+    static uint32_t type_id() {
+        return DenseTypeId<EventIdDomain>::of<Derived>();
+    }
+
     const Derived& as_derived() const {
         return static_cast<const Derived&>(*this);
     }
 };
 
 // 事件类型定义（保持不变）
+// 名称以字符串保存，构造/assign 不查驻留表；name_symbol() 按需查找（不插入），未驻留的名字为空符号
 class TensorEvent : public Event<TensorEvent> {
 public:
     TensorEvent(std::string name, std::vector<int64_t> shape, std::string dtype)
         : name_(std::move(name)), shape_(std::move(shape)), dtype_(std::move(dtype)) {}
 
+    // 复用已有容量重新赋值（对象池回收的对象再次使用时调用，稳态下不分配堆内存）
+    void assign(std::string_view name, const std::vector<int64_t>& shape, std::string_view dtype) {
+        name_.assign(name.data(), name.size());
+        shape_.assign(shape.begin(), shape.end());
+        dtype_.assign(dtype.data(), dtype.size());
+    }
+
     const std::string& name() const { return name_; }
     const std::vector<int64_t>& shape() const { return shape_; }
     const std::string& dtype() const { return dtype_; }
 
+    Symbol name_symbol() const { return Symbol::lookup(name_); }
+
 private:
     std::string name_;
     std::vector<int64_t> shape_;
@@ -48,13 +77,23 @@ class OpAddEvent : public Event<OpAddEvent> {
 public:
     OpAddEvent(std::string name, std::string input1, std::string input2, std::string output)
         : name_(std::move(name)), input1_(std::move(input1)),
-          input2_(std::move(input2)), output_(std::move(output)) {}
+          input2_(std::move(input2)), output_(std::move(output)) {
+    }
+
+    void assign(std::string_view name, std::string_view input1, std::string_view input2, std::string_view output) {
+        name_.assign(name.data(), name.size());
+        input1_.assign(input1.data(), input1.size());
+        input2_.assign(input2.data(), input2.size());
+        output_.assign(output.data(), output.size());
+    }
 
     const std::string& name() const { return name_; }
     const std::string& input1() const { return input1_; }
     const std::string& input2() const { return input2_; }
     const std::string& output() const { return output_; }
 
+    Symbol name_symbol() const { return Symbol::lookup(name_); }
+
 private:
     std::string name_;
     std::string input1_;
@@ -66,7 +105,17 @@ class OpMMAEvent : public Event<OpMMAEvent> {
 public:
     OpMMAEvent(std::string name, std::string a, std::string b, std::string c, std::string output)
         : name_(std::move(name)), a_(std::move(a)), b_(std::move(b)),
-          c_(std::move(c)), output_(std::move(output)) {}
+          c_(std::move(c)), output_(std::move(output)) {
+    }
+
+    void assign(std::string_view name, std::string_view a, std::string_view b,
+                std::string_view c, std::string_view output) {
+        name_.assign(name.data(), name.size());
+        a_.assign(a.data(), a.size());
+        b_.assign(b.data(), b.size());
+        c_.assign(c.data(), c.size());
+        output_.assign(output.data(), output.size());
+    }
 
     const std::string& name() const { return name_; }
     const std::string& a() const { return a_; }
@@ -74,6 +123,8 @@ public:
     const std::string& c() const { return c_; }
     const std::string& output() const { return output_; }
 
+    Symbol name_symbol() const { return Symbol::lookup(name_); }
+
 private:
     std::string name_;
     std::string a_;
@@ -82,131 +133,483 @@ private:
     std::string output_;
 };
 
-// 二次处理器（保持不变）
+// 二次处理器：以结构化字段输出，日志处理方可直接按字段读取
 class TensorHandler {
 public:
     void handle(const TensorEvent& event) {
-        PROJ_INFO("TensorHandler: CreateTensor name={}, dtype={}, shape=[",
-                  event.name(), event.dtype());
-        for (size_t i = 0; i < event.shape().size(); ++i) {
-            if (i > 0) PROJ_DEBG(", ");
-            PROJ_DEBG("{}", event.shape()[i]);
-        }
-        PROJ_DEBG("]");
+        PROJ_INFO_KV("CreateTensor",
+                     proj_logger::kv("handler", "TensorHandler"),
+                     proj_logger::kv("name", event.name()),
+                     proj_logger::kv("dtype", event.dtype()),
+                     proj_logger::kv("shape", event.shape()));
+    }
+
+    // 批量处理：一批张量合并为一条记录
+    void handle(Span<const TensorEvent> events) {
+        PROJ_INFO_KV("CreateTensorBatch",
+                     proj_logger::kv("handler", "TensorHandler"),
+                     proj_logger::kv("count", events.size()),
+                     proj_logger::kv("names", proj_logger::projected(events, &TensorEvent::name)));
     }
 };
 
 class OpHandler {
 public:
     void handle(const OpAddEvent& event) {
-        PROJ_INFO("OpHandler: CreateOpAdd name={}, {} + {} -> {}",
-                  event.name(), event.input1(), event.input2(), event.output());
+        PROJ_INFO_KV("CreateOpAdd",
+                     proj_logger::kv("handler", "OpHandler"),
+                     proj_logger::kv("name", event.name()),
+                     proj_logger::kv("input1", event.input1()),
+                     proj_logger::kv("input2", event.input2()),
+                     proj_logger::kv("output", event.output()));
     }
 
     void handle(const OpMMAEvent& event) {
-        PROJ_INFO("OpHandler: CreateOpMMA name={}, {} * {} + {} -> {}",
-                  event.name(), event.a(), event.b(), event.c(), event.output());
+        PROJ_INFO_KV("CreateOpMMA",
+                     proj_logger::kv("handler", "OpHandler"),
+                     proj_logger::kv("name", event.name()),
+                     proj_logger::kv("a", event.a()),
+                     proj_logger::kv("b", event.b()),
+                     proj_logger::kv("c", event.c()),
+                     proj_logger::kv("output", event.output()));
     }
 };
 
+// 处理器是否提供批量重载 handle(Span<const EventType>)
+template <typename Handler, typename EventType, typename = void>
+struct HasBatchHandle : std::false_type {};
+
+template <typename Handler, typename EventType>
+struct HasBatchHandle<Handler, EventType,
+                      std::void_t<decltype(std::declval<Handler&>().handle(std::declval<Span<const EventType>>()))>>
+    : std::true_type {};
+
+// 异步投递（post）配置：首次 post 时才创建工作线程池
+// 指定 executor 时改用外部执行器（如 WorkStealingExecutor，可与 Router 共享），忽略其余字段
+struct PostConfig {
+    size_t workers = 2;
+    size_t queue_capacity = 1024;
+    BackpressurePolicy policy = BackpressurePolicy::BLOCK;
+    std::shared_ptr<Executor> executor;
+};
+
 // 主类ApiBase（支持多线程处理和安全析构）
+// 处理器表为不可变快照：process 无锁查表、直接调用表内处理器；注册时复制出新表再原子发布
+// 快照只保存处理器指针，处理器对象（内联可调用对象，不分配堆内存）由 handler_storage_ 持有
 class ApiBase : public NoCopyMove {
 public:
-    ApiBase() : destroyed_(false), active_handlers_(0) {}
+    // 完成回调：参数为处理器是否成功执行
+    using PostCallback = InlineFunction<void(bool)>;
+
+    explicit ApiBase(PostConfig post_config = PostConfig())
+        : post_config_(std::move(post_config)), closing_(false), destroyed_(false) {
+        if (post_config_.executor) {
+            executor_.store(post_config_.executor.get(), std::memory_order_release);
+        }
+    }
 
     ~ApiBase() {
-        // 1. 标记为已销毁，阻止新的处理和注册
-        destroyed_.store(true, std::memory_order_seq_cst);
+        // 1. 停止接收新的post，等待正在投递的调用返回
+        closing_.store(true, std::memory_order_seq_cst);
+        wait_inactive();
 
-        // 2. 等待所有正在处理的事件完成
-        std::unique_lock<std::mutex> lock(exit_mutex_);
-        exit_cv_.wait(lock, [this]() {
-            return active_handlers_.load(std::memory_order_seq_cst) == 0;
-        });
+        // 2. 等待本对象投递的事件处理完（仍正常处理），然后停止自有的工作线程
+        //    外部执行器可能被共享，不等待其他使用方的任务
+        drain();
+        owned_executor_.reset();
+
+        // 3. 标记为已销毁，阻止新的处理和注册，等待所有正在处理的事件完成
+        destroyed_.store(true, std::memory_order_seq_cst);
+        wait_inactive();
 
-        // 3. 安全清理资源
+        // 4. 安全清理资源（已无读者，退休快照可直接回收）
         std::lock_guard<std::mutex> handler_lock(handlers_mutex_);
-        handlers_.clear();
+        handlers_.publish(std::make_unique<HandlerMap>());
+        handlers_.reclaim();
+        handler_store_.clear();
+        batch_store_.clear();
         PROJ_INFO("ApiBase destroyed, all resources released");
     }
 
     // 注册处理器（线程安全）
-    template <typename EventType>
-    void register_handler(std::function<void(const EventType&)> handler) {
+    template <typename EventType, typename Fn>
+    void register_handler(Fn&& handler) {
         if (destroyed_.load(std::memory_order_seq_cst)) {
             PROJ_WARN("ApiBase has been destroyed, ignore register handler");
             return;
         }
 
+        update_handlers([&](HandlerMap& handlers) {
+            install(handlers, EventType::type_id(),
+                    [handler = std::forward<Fn>(handler)](const void* event_ptr) {
+                        handler(*static_cast<const EventType*>(event_ptr));
+                    });
+        });
+    }
+
+    // 注册批量处理器（线程安全）：process_batch 整批调用一次；替换单事件处理器时被清除
+    template <typename EventType, typename Fn>
+    void register_batch_handler(Fn&& handler) {
+        if (destroyed_.load(std::memory_order_seq_cst)) {
+            PROJ_WARN("ApiBase has been destroyed, ignore register handler");
+            return;
+        }
+
+        update_handlers([&](HandlerMap& handlers) {
+            install_batch(handlers, EventType::type_id(),
+                          [handler = std::forward<Fn>(handler)](const void* events, size_t count) {
+                              handler(Span<const EventType>(static_cast<const EventType*>(events), count));
+                          });
+        });
+    }
+
+    // 尚未回收的退休快照数（监控/测试用）
+    size_t retired_snapshot_count() {
         std::lock_guard<std::mutex> lock(handlers_mutex_);
-        handlers_[EventType::type()] = [handler = std::move(handler)](const void* event_ptr) {
-            handler(*static_cast<const EventType*>(event_ptr));
-        };
+        return handlers_.retired_count();
     }
 
-    // 处理事件（多线程并行支持）
+    // 处理事件（多线程并行支持），在调用线程上执行处理器
     template <typename EventType>
     void process(const EventType& event) {
+        dispatch(event);
+    }
+
+    // 批量处理：整批只做一次销毁检查、查表与活跃计数
+    // 有批量处理器时整批调用一次，否则逐个调用单事件处理器（单个异常不影响其余事件）
+    template <typename EventType>
+    void process_batch(Span<const EventType> events) {
+        if (events.empty()) {
+            return;
+        }
+        ActiveGuard guard(*this);
         if (destroyed_.load(std::memory_order_seq_cst)) {
-            PROJ_WARN("ApiBase has been destroyed, ignore process event");
+            PROJ_WARN_EVERY_MS(1000, "ApiBase has been destroyed, ignore process batch");
             return;
         }
 
-        // 1. 先检查是否有已注册的处理器（轻量锁）
-        std::function<void(const void*)> handler;
-        {
-            std::lock_guard<std::mutex> lock(handlers_mutex_);
-            auto it = handlers_.find(EventType::type());
-            if (it != handlers_.end()) {
-                handler = it->second; // 复制处理器到栈上，释放锁后执行
+        const HandlerEntry entry = lookup<EventType>();
+        if (entry.batch != nullptr) {
+            try {
+                (*entry.batch)(events.data(), events.size());
+            } catch (...) {
+                PROJ_WARN_EVERY_MS(1000, "Exception occurred while processing event batch");
+            }
+            return;
+        }
+        if (entry.handler == nullptr) {
+            return;
+        }
+        for (const EventType& event : events) {
+            try {
+                (*entry.handler)(&event);
+            } catch (...) {
+                PROJ_WARN_EVERY_MS(1000, "Exception occurred while processing event");
             }
         }
+    }
 
-        // 2. 如果没有处理器，注册默认处理器（加锁操作）
-        if (!handler) {
-            register_default_handler<EventType>();
-            // 再次获取处理器
-            std::lock_guard<std::mutex> lock(handlers_mutex_);
-            auto it = handlers_.find(EventType::type());
-            if (it != handlers_.end()) {
-                handler = it->second;
-            } else {
-                PROJ_WARN("No handler for event type: {}", typeid(EventType).name());
-                return;
+    // 异步投递：事件移入有界队列，由工作线程池处理，调用方不被慢处理器阻塞
+    // 返回false表示已关闭或被背压策略拒绝；done 在处理完成（或被拒绝）时调用
+    template <typename EventType>
+    bool post(EventType event, PostCallback done = nullptr) {
+        ActiveGuard guard(*this);
+        if (closing_.load(std::memory_order_seq_cst)) {
+            PROJ_WARN_EVERY_MS(1000, "ApiBase is shutting down, ignore post event");
+            if (done) done(false);
+            return false;
+        }
+
+        auto posted = ObjectPool<PostedEvent<EventType>>::make(std::move(event), std::move(done));
+        PostedEvent<EventType>* pending = posted.get();
+        ExecutorTask task([this, posted = std::move(posted)]() {
+            PendingTasks::Scope finished(posted_);
+            const bool handled = dispatch(posted->event);
+            if (posted->done) {
+                posted->done(handled);
+                posted->done = nullptr; // 回收进对象池前释放回调捕获的资源
+            }
+        });
+        posted_.add();
+        if (!executor().submit(std::move(task))) {
+            // 被拒绝时任务未被移走，pending 仍有效
+            posted_.finish();
+            PROJ_WARN_EVERY_MS(1000, "ApiBase post queue full, event rejected");
+            if (pending->done) {
+                pending->done(false);
+                pending->done = nullptr;
             }
+            return false;
+        }
+        return true;
+    }
+
+    // 异步投递，通过future获取处理结果
+    template <typename EventType>
+    std::future<bool> post_future(EventType event) {
+        auto promise = std::make_shared<std::promise<bool>>();
+        std::future<bool> result = promise->get_future();
+        post(std::move(event), [promise](bool handled) { promise->set_value(handled); });
+        return result;
+    }
+
+    // 等待本对象已投递的事件全部处理完成（共享执行器上其他使用方的任务不在等待之列）
+    void drain() {
+        posted_.wait_idle();
+    }
+
+private:
+    using HandlerFunc = InlineFunction<void(const void*)>;
+    using BatchHandlerFunc = InlineFunction<void(const void*, size_t)>; // 连续事件数组首地址与个数
+
+    // 快照表项：只保存处理器指针，可整体复制
+    struct HandlerEntry {
+        const HandlerFunc* handler = nullptr;
+        const BatchHandlerFunc* batch = nullptr;
+
+        explicit operator bool() const { return handler != nullptr || batch != nullptr; }
+    };
+    using HandlerMap = std::vector<HandlerEntry>; // 下标为事件的稠密类型ID
+
+    template <typename EventType>
+    struct PostedEvent {
+        PostedEvent(EventType e, PostCallback d) : event(std::move(e)), done(std::move(d)) {}
+
+        void assign(EventType e, PostCallback d) {
+            event = std::move(e);
+            done = std::move(d);
         }
 
-        // 3. 并行执行事件处理（无锁）
-        active_handlers_.fetch_add(1, std::memory_order_acq_rel);
+        EventType event;
+        PostCallback done;
+    };
+
+    // 查表并调用处理器，返回处理器是否成功执行
+    template <typename EventType>
+    bool dispatch(const EventType& event) {
+        // 先登记为活跃读者：之后读到的快照在本次处理结束前不会被回收，析构也会等待
+        ActiveGuard guard(*this);
+        if (destroyed_.load(std::memory_order_seq_cst)) {
+            PROJ_WARN_EVERY_MS(1000, "ApiBase has been destroyed, ignore process event");
+            return false;
+        }
+
+        const HandlerEntry entry = lookup<EventType>();
+        if (!entry) {
+            return false;
+        }
+
+        // 直接调用快照内的处理器（无拷贝，多线程并行执行）；只有批量处理器时按单元素批调用
         try {
-            handler(&event); // 实际处理逻辑（多线程并行执行）
+            if (entry.handler != nullptr) {
+                (*entry.handler)(&event);
+            } else {
+                (*entry.batch)(&event, 1);
+            }
+            return true;
         } catch (...) {
-            PROJ_WARN("Exception occurred while processing event");
+            PROJ_WARN_EVERY_MS(1000, "Exception occurred while processing event");
+            return false;
         }
-        active_handlers_.fetch_sub(1, std::memory_order_acq_rel);
-        exit_cv_.notify_one(); // 通知析构线程可能可以退出
     }
 
-private:
+    // 调用方须已登记为活跃读者
+    template <typename EventType>
+    HandlerEntry lookup() {
+        // 1. 无锁查表：按稠密类型ID直接索引
+        const uint32_t id = EventType::type_id();
+        HandlerEntry entry = find(*handlers_.load(), id);
+
+        // 2. 如果没有处理器，注册默认处理器（发布新快照）后重新查表
+        if (!entry) {
+            register_default_handler<EventType>();
+            entry = find(*handlers_.load(), id);
+            if (!entry) {
+                PROJ_WARN_EVERY_MS(1000, "No handler for event type: {}", typeid(EventType).name());
+            }
+        }
+        return entry;
+    }
+
+    // 首次投递时创建工作线程池
+    Executor& executor() {
+        Executor* executor = executor_.load(std::memory_order_acquire);
+        if (executor == nullptr) {
+            std::lock_guard<std::mutex> lock(executor_mutex_);
+            executor = executor_.load(std::memory_order_relaxed);
+            if (executor == nullptr) {
+                owned_executor_ = std::make_unique<ThreadPool>(
+                    post_config_.workers, post_config_.queue_capacity, post_config_.policy);
+                executor = owned_executor_.get();
+                executor_.store(executor, std::memory_order_release);
+            }
+        }
+        return *executor;
+    }
+
+    // 等待活跃计数归零（析构期间调用）
+    // 在 closing_ 置位前开始的读者退出时不会通知，靠定时重新检查兜底
+    void wait_inactive() {
+        std::unique_lock<std::mutex> lock(exit_mutex_);
+        while (!exit_cv_.wait_for(lock, std::chrono::milliseconds(1),
+                                  [this]() { return active_handlers_.is_zero(); })) {
+        }
+    }
+
+    // 处理器对象的持久存储：被替换的对象先退休，与旧快照同时回收
+    template <typename Func>
+    struct HandlerStore {
+        std::unordered_map<uint32_t, std::unique_ptr<Func>> current;
+        std::vector<std::unique_ptr<Func>> retired;  // 本代退休
+        std::vector<std::unique_ptr<Func>> pending;  // 上一代退休，等待宽限期结束
+
+        const Func* replace(uint32_t id, Func func) {
+            retire(id);
+            auto& owned = current[id];
+            owned = std::make_unique<Func>(std::move(func));
+            return owned.get();
+        }
+
+        void retire(uint32_t id) {
+            auto it = current.find(id);
+            if (it != current.end()) {
+                retired.push_back(std::move(it->second));
+                current.erase(it);
+            }
+        }
+
+        // 与 SnapshotPtr::advance 同步：回收上一代，本代转入等待
+        void advance() {
+            pending = std::move(retired);
+            retired.clear();
+        }
+
+        void clear() {
+            current.clear();
+            retired.clear();
+            pending.clear();
+        }
+    };
+
+    static HandlerEntry find(const HandlerMap& handlers, uint32_t id) {
+        return id < handlers.size() ? handlers[id] : HandlerEntry();
+    }
+
+    static HandlerEntry& entry_of(HandlerMap& handlers, uint32_t id) {
+        if (handlers.size() <= id) {
+            handlers.resize(id + 1);
+        }
+        return handlers[id];
+    }
+
+    // 写者：安装单事件处理器，同时清除旧的批量处理器
+    void install(HandlerMap& handlers, uint32_t id, HandlerFunc func) {
+        HandlerEntry& entry = entry_of(handlers, id);
+        entry.handler = handler_store_.replace(id, std::move(func));
+        entry.batch = nullptr;
+        batch_store_.retire(id);
+    }
+
+    void install_batch(HandlerMap& handlers, uint32_t id, BatchHandlerFunc func) {
+        entry_of(handlers, id).batch = batch_store_.replace(id, std::move(func));
+    }
+
+    // 活跃处理计数守卫（处理与投递均计入）：热路径只修改本线程的计数槽
+    // 析构期间在 exit_mutex_ 内退出并唤醒析构线程：析构线程持锁检查计数，
+    // 因此退出后不会再访问已释放的对象
+    class ActiveGuard {
+    public:
+        explicit ActiveGuard(ApiBase& owner)
+            : owner_(owner), slot_(owner.active_handlers_.enter()) {}
+
+        ~ActiveGuard() {
+            if (owner_.closing_.load(std::memory_order_acquire)) {
+                std::lock_guard<std::mutex> lock(owner_.exit_mutex_);
+                GracePeriodCounter::leave(slot_);
+                owner_.exit_cv_.notify_all();
+            } else {
+                GracePeriodCounter::leave(slot_);
+            }
+        }
+
+    private:
+        ApiBase& owner_;
+        GracePeriodCounter::Slot& slot_;
+    };
+
+    // 写者：复制当前快照 -> 修改 -> 发布，然后尝试按宽限期逐代回收
+    // 上一纪元的读者已全部退出时，回收上一代退休的快照与处理器对象，本次退休的转入下一代；
+    // 否则留到下次发布时重试（退休列表只保留尚未过宽限期的几代，不会随注册次数无限增长）
+    template <typename Fn>
+    void update_handlers(Fn&& fn) {
+        std::lock_guard<std::mutex> lock(handlers_mutex_);
+        auto next = std::make_unique<HandlerMap>(handlers_.current());
+        fn(*next);
+        handlers_.publish(std::move(next));
+        if (active_handlers_.try_advance()) {
+            handlers_.advance();
+            handler_store_.advance();
+            batch_store_.advance();
+        }
+    }
+
+    // 写者：处理器是否已注册
+    bool has_handler(uint32_t id) {
+        std::lock_guard<std::mutex> lock(handlers_mutex_);
+        return static_cast<bool>(find(handlers_.current(), id));
+    }
+
     // 通用默认处理器注册（线程安全）
     template <typename EventType>
     void register_default_handler() {
-        std::lock_guard<std::mutex> lock(handlers_mutex_);
         // 双重检查，避免重复注册
-        if (handlers_.find(EventType::type()) != handlers_.end()) {
+        if (has_handler(EventType::type_id())) {
             return;
         }
-        PROJ_WARN("No default handler defined for event type: {}", typeid(EventType).name());
+        PROJ_WARN_EVERY_MS(1000, "No default handler defined for event type: {}", typeid(EventType).name());
+    }
+
+    // 注册内置默认处理器（已注册则跳过）
+    template <typename EventType, typename Handler>
+    void register_builtin_handler(Handler& handler, const char* event_name) {
+        bool registered = false;
+        update_handlers([&](HandlerMap& handlers) {
+            if (find(handlers, EventType::type_id())) {
+                return;
+            }
+            install(handlers, EventType::type_id(), [&handler](const void* event_ptr) {
+                handler.handle(*static_cast<const EventType*>(event_ptr));
+            });
+            if constexpr (HasBatchHandle<Handler, EventType>::value) {
+                install_batch(handlers, EventType::type_id(), [&handler](const void* events, size_t count) {
+                    handler.handle(Span<const EventType>(static_cast<const EventType*>(events), count));
+                });
+            }
+            registered = true;
+        });
+        if (registered) {
+            PROJ_INFO("Lazy registered default handler for {}", event_name);
+        }
     }
 
 private:
-    // 处理器映射表及保护锁
-    std::unordered_map<std::type_index, std::function<void(const void*)>> handlers_;
+    // 处理器快照表；写者由 handlers_mutex_ 串行化
+    SnapshotPtr<HandlerMap> handlers_;
     std::mutex handlers_mutex_;
+    HandlerStore<HandlerFunc> handler_store_;
+    HandlerStore<BatchHandlerFunc> batch_store_;
+
+    // 异步投递
+    const PostConfig post_config_;
+    std::atomic<Executor*> executor_{nullptr};  // 首次投递后发布
+    std::unique_ptr<Executor> owned_executor_;
+    std::mutex executor_mutex_;
+    PendingTasks posted_;                       // 本对象投递、尚未完成的事件
 
     // 线程安全析构相关
+    std::atomic<bool> closing_;                 // 停止接收投递（析构第一步）
     std::atomic<bool> destroyed_;               // 析构标志（seq_cst保证可见性）
-    std::atomic<int> active_handlers_;          // 活跃处理器计数（acq_rel保证同步）
+    GracePeriodCounter active_handlers_;        // 活跃处理计数（分条、按纪元轮换），同时作为快照读者计数
     std::mutex exit_mutex_;                     // 条件变量锁
     std::condition_variable exit_cv_;           // 析构等待条件变量
 
@@ -215,42 +618,21 @@ private:
     OpHandler op_handler_;
 };
 
-// 显式特化默认处理器（保持不变）
+// 显式特化默认处理器
 template <>
-void ApiBase::register_default_handler<TensorEvent>() {
-    std::lock_guard<std::mutex> lock(handlers_mutex_);
-    if (handlers_.find(TensorEvent::type()) != handlers_.end()) {
-        return;
-    }
-    handlers_[TensorEvent::type()] = [this](const void* event_ptr) {
-        this->tensor_handler_.handle(*static_cast<const TensorEvent*>(event_ptr));
-    };
-    PROJ_INFO("Lazy registered default handler for TensorEvent");
+inline void ApiBase::register_default_handler<TensorEvent>() {
+    register_builtin_handler<TensorEvent>(tensor_handler_, "TensorEvent");
 }
 
 template <>
-void ApiBase::register_default_handler<OpAddEvent>() {
-    std::lock_guard<std::mutex> lock(handlers_mutex_);
-    if (handlers_.find(OpAddEvent::type()) != handlers_.end()) {
-        return;
-    }
-    handlers_[OpAddEvent::type()] = [this](const void* event_ptr) {
-        this->op_handler_.handle(*static_cast<const OpAddEvent*>(event_ptr));
-    };
-    PROJ_INFO("Lazy registered default handler for OpAddEvent");
+inline void ApiBase::register_default_handler<OpAddEvent>() {
+    register_builtin_handler<OpAddEvent>(op_handler_, "OpAddEvent");
 }
 
 template <>
-void ApiBase::register_default_handler<OpMMAEvent>() {
-    std::lock_guard<std::mutex> lock(handlers_mutex_);
-    if (handlers_.find(OpMMAEvent::type()) != handlers_.end()) {
-        return;
-    }
-    handlers_[OpMMAEvent::type()] = [this](const void* event_ptr) {
-        this->op_handler_.handle(*static_cast<const OpMMAEvent*>(event_ptr));
-    };
-    PROJ_INFO("Lazy registered default handler for OpMMAEvent");
+inline void ApiBase::register_default_handler<OpMMAEvent>() {
+    register_builtin_handler<OpMMAEvent>(op_handler_, "OpMMAEvent");
 }
 
 } // namespace event
-} // namespace proj
\ No newline at end of file
+} // namespace proj
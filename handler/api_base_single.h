@@ -8,37 +8,102 @@
 #include <thread>
 #include <stdexcept>
 #include <cassert>
+#include <chrono>
 #include "../common/log.h"
 #include "../../engine_base/no_copy_move.h"
+#include "../../engine_base/inline_function.h"
+#include "../../engine_base/bounded_queue.h"
+#include "../../engine_base/object_pool.h"
 #include "api_base.h"
 
 namespace proj {
 namespace event {
 
 // ApiBaseSingle类实现
+// 处理器表只由绑定线程访问（无锁）；其他线程通过无锁MPSC邮箱 submit 事件，
+// 由绑定线程调用 run_once()/run_until() 取出处理（actor模型）
 class ApiBaseSingle : public NoCopyMove {
 public:
-    // C++17: constexpr构造函数
-    ApiBaseSingle() noexcept
+    static constexpr size_t kDefaultMailboxCapacity = 1024;
+
+    explicit ApiBaseSingle(size_t mailbox_capacity = kDefaultMailboxCapacity)
         : bound_thread_id_(std::this_thread::get_id()),
-          destroyed_(false) {}
+          destroyed_(false),
+          mailbox_(mailbox_capacity) {}
 
-    // C++17: noexcept析构函数
+    // C++17: noexcept析构函数；邮箱中未处理的事件直接丢弃
     ~ApiBaseSingle() noexcept {
         destroyed_ = true;
-        PROJ_INFO("ApiBaseSingle destroyed, registered handler count: {}", handlers_.size());
+        PROJ_INFO("ApiBaseSingle destroyed, registered handler count: {}, dropped mailbox events: {}",
+                  handlers_.size(), mailbox_.size_approx());
     }
 
-    // 注册处理器 - 仅允许绑定线程调用
+    // 投递事件到邮箱 - 任意线程可调用（无锁）；邮箱满时返回false
     template <typename EventType>
-    void register_handler(std::function<void(const EventType&)> handler) {
+    bool submit(EventType event) {
+        auto owned = ObjectPool<EventType>::make(std::move(event));
+        MailboxTask task([this, owned = std::move(owned)]() { process(*owned); });
+        if (!mailbox_.try_push(std::move(task))) {
+            PROJ_WARN_EVERY_MS(1000, "ApiBaseSingle mailbox full, event rejected");
+            return false;
+        }
+        return true;
+    }
+
+    // 处理邮箱中当前已有的事件 - 仅允许绑定线程调用；返回处理个数
+    // 只处理进入时已入队的数量，持续投递时也能及时返回
+    size_t run_once() {
+        check_thread();
+        size_t budget = mailbox_.size_approx();
+        size_t handled = 0;
+        MailboxTask task;
+        while (handled < budget && mailbox_.try_pop(task)) {
+            task();
+            task = nullptr;
+            ++handled;
+        }
+        return handled;
+    }
+
+    // 循环处理邮箱直到 stop() 返回true - 仅允许绑定线程调用；返回处理总数
+    // 邮箱为空时先让出CPU再短暂休眠，不引入锁
+    template <typename Pred>
+    size_t run_until(Pred&& stop) {
+        size_t total = 0;
+        int idle_rounds = 0;
+        while (!stop()) {
+            const size_t handled = run_once();
+            total += handled;
+            if (handled > 0) {
+                idle_rounds = 0;
+            } else if (++idle_rounds < 64) {
+                std::this_thread::yield();
+            } else {
+                std::this_thread::sleep_for(std::chrono::microseconds(50));
+            }
+        }
+        return total;
+    }
+
+    // 循环处理邮箱直到截止时间
+    size_t run_until(std::chrono::steady_clock::time_point deadline) {
+        return run_until([deadline]() { return std::chrono::steady_clock::now() >= deadline; });
+    }
+
+    // 注册处理器 - 仅允许绑定线程调用
+    template <typename EventType, typename Fn>
+    void register_handler(Fn&& handler) {
         check_thread();
         if (destroyed_) {
             PROJ_WARN("ApiBaseSingle has been destroyed, ignore register handler");
             return;
         }
 
-        handlers_[EventType::type()] = [handler = std::move(handler)](const void* event_ptr) {
+        const uint32_t id = EventType::type_id();
+        if (handlers_.size() <= id) {
+            handlers_.resize(id + 1);
+        }
+        handlers_[id] = [handler = std::forward<Fn>(handler)](const void* event_ptr) {
             handler(*static_cast<const EventType*>(event_ptr));
         };
     }
@@ -48,24 +113,23 @@ public:
     void process(const EventType& event) {
         check_thread();
         if (destroyed_) {
-            PROJ_WARN("ApiBaseSingle has been destroyed, ignore process event");
+            PROJ_WARN_EVERY_MS(1000, "ApiBaseSingle has been destroyed, ignore process event");
             return;
         }
 
-        const auto type = EventType::type();
-        auto it = handlers_.find(type);
-        if (it != handlers_.end()) {
-            it->second(&event);
+        // 按稠密类型ID直接索引
+        const uint32_t id = EventType::type_id();
+        if (id < handlers_.size() && handlers_[id]) {
+            handlers_[id](&event);
             return;
         }
 
         // 延迟注册默认处理器
         register_default_handler<EventType>();
-        it = handlers_.find(type);
-        if (it != handlers_.end()) {
-            it->second(&event);
+        if (id < handlers_.size() && handlers_[id]) {
+            handlers_[id](&event);
         } else {
-            PROJ_WARN("No handler registered for event type: {}", typeid(EventType).name());
+            PROJ_WARN_EVERY_MS(1000, "No handler registered for event type: {}", typeid(EventType).name());
         }
     }
 
@@ -79,10 +143,10 @@ private:
     void check_thread() const {
         const auto current_thread = std::this_thread::get_id();
         if (current_thread != bound_thread_id_) {
-            PROJ_ERRO("ApiBaseSingle accessed from wrong thread! "
-                      "Bound: {}, Current: {}",
-                      std::hash<std::thread::id>{}(bound_thread_id_),
-                      std::hash<std::thread::id>{}(current_thread));
+            PROJ_ERRO_EVERY_MS(1000, "ApiBaseSingle accessed from wrong thread! "
+                               "Bound: {}, Current: {}",
+                               std::hash<std::thread::id>{}(bound_thread_id_),
+                               std::hash<std::thread::id>{}(current_thread));
             throw std::runtime_error("Cross-thread access to ApiBaseSingle");
         }
     }
@@ -90,13 +154,15 @@ private:
     // 默认处理器注册（通用版本）
     template <typename EventType>
     void register_default_handler() {
-        PROJ_WARN("No default handler for event type: {}", typeid(EventType).name());
+        PROJ_WARN_EVERY_MS(1000, "No default handler for event type: {}", typeid(EventType).name());
     }
 
 private:
     const std::thread::id bound_thread_id_;  // 绑定的线程ID
     bool destroyed_;                         // 销毁标志
-    std::unordered_map<std::type_index, std::function<void(const void*)>> handlers_;
+    std::vector<InlineFunction<void(const void*)>> handlers_; // 下标为事件的稠密类型ID
+    using MailboxTask = InlineFunction<void()>;
+    BoundedMPMCQueue<MailboxTask> mailbox_;  // 跨线程投递邮箱（多生产者，绑定线程消费）
     TensorHandler tensor_handler_;           // 内置Tensor处理器
     OpHandler op_handler_;                   // 内置Op处理器
 };
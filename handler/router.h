@@ -1,19 +1,39 @@
 #pragma once
 #include <string>
+#include <string_view>
 #include <unordered_map>
+#include <vector>
 #include <functional>
 #include <mutex>
 #include <memory>
 #include <typeindex>
 #include <type_traits>
-#include <any>
+#include <tuple>
 #include <stdexcept>
+#include <algorithm>
 #include "api_base.h"
+#include "../../engine_base/dense_type_id.h"
+#include "../../engine_base/inline_function.h"
+#include "../../engine_base/executor.h"
+#include "../../engine_base/sharded_executor.h"
+#include "../../engine_base/span.h"
+#include "../../engine_base/object_pool.h"
+#include "../../engine_base/snapshot_ptr.h"
 #include "../proj/common/log.h"
 
 namespace proj {
 namespace msg {
 
+// 消息类型ID域
+struct MsgIdDomain {};
+
+// 派生消息可实现 uint64_t key_impl() const 自定义分片键
+template <typename Msg, typename = void>
+struct HasKeyImpl : std::false_type {};
+
+template <typename Msg>
+struct HasKeyImpl<Msg, std::void_t<decltype(std::declval<const Msg&>().key_impl())>> : std::true_type {};
+
 // ========================== 事件CRTP基类（零虚函数，纯静态多态） ==========================
 template <typename Derived>
 class MsgCRTP : public NoCopyMove {
@@ -27,6 +47,16 @@ public:
         return static_cast<const Derived*>(this)->name_impl();
     }
 
+    // 分片键：相同键的消息在分片执行时保序；默认为消息名的哈希
+    uint64_t key() const {
+        const Derived* self = static_cast<const Derived*>(this);
+        if constexpr (HasKeyImpl<Derived>::value) {
+            return self->key_impl();
+        } else {
+            return std::hash<std::string_view>{}(self->name());
+        }
+    }
+
     // 静态获取事件类型索引（编译期常量，无运行时开销）
     static std::type_index TypeIndex() {
         return std::type_index(typeid(Derived));
@@ -37,6 +67,11 @@ public:
         return Derived::TypeIndex();
     }
 
+    // 稠密类型ID：路由表按此下标直接索引
+    static uint32_t TypeId() {
+        return DenseTypeId<MsgIdDomain>::of<Derived>();
+    }
+
     // 非虚析构：静态多态下，不会用基类指针持有派生类对象，无需虚析构
     ~MsgCRTP() = default;
 
@@ -51,6 +86,14 @@ public:
     OpAddMsg(std::string name, std::string input1, std::string input2, std::string output)
         : name_(std::move(name)), input1_(std::move(input1)), input2_(std::move(input2)), output_(std::move(output)) {}
 
+    // 复用已有容量重新赋值（对象池回收的消息再次使用时调用）
+    void assign(std::string_view name, std::string_view input1, std::string_view input2, std::string_view output) {
+        name_.assign(name.data(), name.size());
+        input1_.assign(input1.data(), input1.size());
+        input2_.assign(input2.data(), input2.size());
+        output_.assign(output.data(), output.size());
+    }
+
     // 静态多态要求的具体实现（替代原虚函数）
     const std::string& name_impl() const { return name_; }
 
@@ -59,6 +102,9 @@ public:
     const std::string& input2() const { return input2_; }
     const std::string& output() const { return output_; }
 
+    // 按需在驻留表中查找名字的符号（不插入）；未驻留的名字为空符号
+    Symbol name_symbol() const { return Symbol::lookup(name_); }
+
     // 非虚析构（默认生成，无额外开销）
     ~OpAddMsg() = default;
 
@@ -74,6 +120,15 @@ public:
     OpMMAMsg(std::string name, std::string a, std::string b, std::string c, std::string output)
         : name_(std::move(name)), a_(std::move(a)), b_(std::move(b)), c_(std::move(c)), output_(std::move(output)) {}
 
+    void assign(std::string_view name, std::string_view a, std::string_view b,
+                std::string_view c, std::string_view output) {
+        name_.assign(name.data(), name.size());
+        a_.assign(a.data(), a.size());
+        b_.assign(b.data(), b.size());
+        c_.assign(c.data(), c.size());
+        output_.assign(output.data(), output.size());
+    }
+
     // 静态多态要求的具体实现（替代原虚函数）
     const std::string& name_impl() const { return name_; }
 
@@ -83,6 +138,8 @@ public:
     const std::string& c() const { return c_; }
     const std::string& output() const { return output_; }
 
+    Symbol name_symbol() const { return Symbol::lookup(name_); }
+
     // 非虚析构（默认生成）
     ~OpMMAMsg() = default;
 
@@ -116,50 +173,141 @@ protected:
     MsgProcessorCRTP() = default;
 };
 
+// ========================== 处理器可重入声明 ==========================
+// 处理器定义 static constexpr bool kReentrant = true 表示 process 可被多个线程同时调用；
+// 未声明视为不可重入，并发分发模式下路由器对其逐个处理器串行化
+template <typename ProcessorType, typename = void>
+struct IsReentrantProcessor : std::false_type {};
+
+template <typename ProcessorType>
+struct IsReentrantProcessor<ProcessorType, std::void_t<decltype(ProcessorType::kReentrant)>>
+    : std::bool_constant<ProcessorType::kReentrant> {};
+
 // ========================== 具体处理器实现（零虚函数） ==========================
 class OpAddProcessor : public MsgProcessorCRTP<OpAddProcessor, OpAddMsg> {
 public:
-    using ImplFunc = std::function<void(const OpAddMsg&)>;
+    using ImplFunc = InlineFunction<void(const OpAddMsg&)>;
+
+    // 实现选择只读冻结表，实现本体地址稳定，可并发处理
+    static constexpr bool kReentrant = true;
 
     OpAddProcessor() {
-        register_impl("default", [this](const OpAddMsg& msg) { impl_default(msg); });
+        register_impl(kDefaultImpl, [this](const OpAddMsg& msg) { impl_default(msg); });
         register_impl("special", [this](const OpAddMsg& msg) { impl_special(msg); });
     }
 
+    // 按消息名选择实现：无锁读取冻结表，按符号ID整数比较，未命中走缓存的默认实现
+    // 消息不携带符号，分发时按名字在驻留表中只查找一次（不插入），之后才注册的实现名同样可以命中
     void process_impl(const OpAddMsg& msg) {
-        auto it = impls_.find(msg.name());
-        (it != impls_.end() ? it->second : impls_["default"])(msg);
+        (*find_impl(msg.name_symbol()))(msg);
+    }
+
+    // 查找符号对应的实现（未注册或空符号时返回默认实现）
+    const ImplFunc* find_impl(Symbol name) const {
+        return table_.load()->find(name);
+    }
+
+    // 按名字查找：先在驻留表中查找（不插入），未驻留的名字必然未注册
+    const ImplFunc* find_impl(std::string_view name) const {
+        return find_impl(Symbol::lookup(name));
     }
 
-    // 注册自定义实现（线程安全）
-    void register_impl(const std::string& name, ImplFunc func) {
+    // 注册自定义实现（线程安全）：驻留实现名后在写锁内重新编译冻结表再发布，正在进行的查找不受影响
+    // 同名替换时旧实现保留到处理器析构，仍在执行旧实现的线程安全
+    // 实现名是有限集合，只有注册会向驻留表插入，分发路径只查找
+    void register_impl(std::string_view name, ImplFunc func) {
+        if (name.empty()) {
+            throw std::invalid_argument("OpAddProcessor impl name must not be empty");
+        }
+        const Symbol symbol(name);
         std::lock_guard<std::mutex> lock(mutex_);
-        // 容错处理
-        impls_[name] = func;
+        impl_storage_.push_back(std::make_unique<ImplFunc>(std::move(func)));
+        registry_[symbol] = impl_storage_.back().get();
+        compile();
     }
 
     ~OpAddProcessor() = default; // 非虚析构
 
 private:
+    static constexpr std::string_view kDefaultImpl = "default";
+
+    // 冻结的实现表：条目按符号ID升序排列在一个扁平数组中，查找只做整数比较
+    // 条目少时顺序扫描，条目多时二分；默认实现预先缓存
+    struct ImplTable {
+        static constexpr size_t kLinearScanLimit = 8;
+
+        struct Entry {
+            Symbol name;
+            const ImplFunc* impl = nullptr;
+        };
+        std::vector<Entry> entries;
+        const ImplFunc* fallback = nullptr;
+
+        const ImplFunc* find(Symbol name) const {
+            if (entries.size() <= kLinearScanLimit) {
+                for (const Entry& entry : entries) {
+                    if (entry.name == name) {
+                        return entry.impl;
+                    }
+                }
+                return fallback;
+            }
+            auto it = std::lower_bound(entries.begin(), entries.end(), name,
+                                       [](const Entry& entry, Symbol value) { return entry.name < value; });
+            return it != entries.end() && it->name == name ? it->impl : fallback;
+        }
+    };
+
+    // 由注册表编译出新的冻结表并发布（调用方持有 mutex_）
+    // 旧表保留到处理器析构时回收，读者无需登记
+    void compile() {
+        auto next = std::make_unique<ImplTable>();
+        next->entries.reserve(registry_.size());
+        for (const auto& [name, impl] : registry_) {
+            next->entries.push_back(ImplTable::Entry{name, impl});
+        }
+        std::sort(next->entries.begin(), next->entries.end(),
+                  [](const auto& lhs, const auto& rhs) { return lhs.name < rhs.name; });
+        auto fallback = registry_.find(default_symbol_);
+        next->fallback = fallback != registry_.end() ? fallback->second : nullptr;
+        table_.publish(std::move(next));
+    }
+
     void impl_default(const OpAddMsg& msg) {
-        PROJ_INFO("OpAdd[default] - {}: {} + {} -> {}",
-                  msg.name(), msg.input1(), msg.input2(), msg.output());
+        log_op_add("default", msg);
     }
 
     void impl_special(const OpAddMsg& msg) {
-        PROJ_INFO("OpAdd[special] - {}: {} + {} -> {}",
-                  msg.name(), msg.input1(), msg.input2(), msg.output());
+        log_op_add("special", msg);
+    }
+
+    static void log_op_add(const char* impl, const OpAddMsg& msg) {
+        PROJ_INFO_KV("OpAdd",
+                     proj_logger::kv("impl", impl),
+                     proj_logger::kv("name", msg.name()),
+                     proj_logger::kv("input1", msg.input1()),
+                     proj_logger::kv("input2", msg.input2()),
+                     proj_logger::kv("output", msg.output()));
     }
 
-    std::unordered_map<std::string, ImplFunc> impls_;
+    SnapshotPtr<ImplTable> table_;                                 // 当前冻结表（读者无锁）
+    std::unordered_map<Symbol, const ImplFunc*> registry_;         // 实现名符号 → 当前实现（写者在锁内维护）
+    const Symbol default_symbol_{kDefaultImpl};
+    std::vector<std::unique_ptr<ImplFunc>> impl_storage_;     // 实现本体，地址稳定
     std::mutex mutex_;
 };
 
 class OpMMAProcessor : public MsgProcessorCRTP<OpMMAProcessor, OpMMAMsg> {
 public:
+    static constexpr bool kReentrant = true; // 无状态
+
     void process_impl(const OpMMAMsg& msg) {
-        PROJ_INFO("OpMMA - {}: {} * {} + {} -> {}",
-                  msg.name(), msg.a(), msg.b(), msg.c(), msg.output());
+        PROJ_INFO_KV("OpMMA",
+                     proj_logger::kv("name", msg.name()),
+                     proj_logger::kv("a", msg.a()),
+                     proj_logger::kv("b", msg.b()),
+                     proj_logger::kv("c", msg.c()),
+                     proj_logger::kv("output", msg.output()));
     }
 
     ~OpMMAProcessor() = default; // 非虚析构
@@ -170,13 +318,25 @@ template <typename MsgType> struct MsgToProcessor;
 template <> struct MsgToProcessor<OpAddMsg> { using Type = OpAddProcessor; };
 template <> struct MsgToProcessor<OpMMAMsg> { using Type = OpMMAProcessor; };
 
+// ========================== 消息改写规则（Router 与 StaticRouter 共用） ==========================
+// MMA 参数校验（纯静态，无虚函数）
+inline bool has_mma_param_error(const OpMMAMsg& msg) {
+    return msg.a().empty() || msg.b().empty() || msg.c().empty();
+}
+
+// 参数错误的 OpMMA 改写为 OpAdd（C++17 保证返回值省略，不可移动的消息也可按值返回）
+// FIXME:: 这里强制转发为 msg.name() + "_redirected",
+inline OpAddMsg make_mma_redirect(const OpMMAMsg& msg) {
+    return OpAddMsg(msg.name() + "_redirected", msg.a(), msg.b(), msg.output());
+}
+
 // ========================== 核心：5个语义化宏定义（放在Router前，便于类内使用） ==========================
 // 宏1：模板版处理器注册（通用，对应用户要求的第二个宏）
 #define REGISTER_PROCESSOR(msg_prefix) \
     do { \
         using MsgType = msg_prefix##Msg; \
         using ProcessorType = msg_prefix##Processor; \
-        register_processor<MsgType, ProcessorType>(std::make_shared<ProcessorType>()); \
+        register_processor<MsgType, ProcessorType>(); \
     } while (0)
 
 // 宏2：重载版处理器注册（语义化命名，逻辑同通用版，对应用户要求的第三个宏）
@@ -206,7 +366,31 @@ template <> struct MsgToProcessor<OpMMAMsg> { using Type = OpMMAProcessor; };
     } while (0)
 
 
+// ========================== 处理器单元（编译期确定，直接成员访问） ==========================
+// 可重入处理器使用空锁，lock_guard 在编译期被完全消除
+struct NoSerialLock {
+    void lock() {}
+    void unlock() {}
+};
+
+template <typename ProcessorType>
+struct ProcessorCell {
+    ProcessorType processor;
+    std::conditional_t<IsReentrantProcessor<ProcessorType>::value, NoSerialLock, std::mutex> serial;
+};
+
+// ========================== 分发模式 ==========================
+// SERIALIZED：整个处理过程持有路由器全局锁，同一时刻只处理一条消息（默认，兼容原语义）
+// CONCURRENT：无全局锁，多线程同时分发；仅对未声明可重入的处理器逐个串行化
+enum class DispatchMode {
+    SERIALIZED,
+    CONCURRENT
+};
+
 // ========================== 路由核心类（零虚函数 + 通用化） ==========================
+// 处理器按类型存放在 tuple 中，获取处理器编译为直接成员访问（无查表、无引用计数原子操作）
+// 处理函数注册在写锁下复制出新的不可变路由表并发布；分发只读取当前路由表，不加锁
+// 注册只发生在构造期间，旧表保留到路由器析构时回收，读者无需登记
 class Router : public NoCopyMove {
 public:
 
@@ -216,23 +400,19 @@ public:
     // ========================== 2. 仅重载 OpMMAMsg 版本（OpAddMsg 不重载） ==========================
     // 否则无法解决模板实例化和特例化的顺序问题
     void process_msg(const OpMMAMsg& msg) {
-        PROJ_INFO("process_msg<OpMMAMsg>.name = {}", msg.name());
+        PROJ_INFO_KV("process_msg", proj_logger::kv("msg", "OpMMAMsg"), proj_logger::kv("name", msg.name()));
         if (has_mma_param_error(msg)) {
-            PROJ_WARN("OpMMA {} has parameter error, redirect to OpAdd", msg.name());
+            PROJ_WARN_KV("OpMMARedirect", proj_logger::kv("name", msg.name()),
+                         proj_logger::kv("reason", "parameter error"), proj_logger::kv("to", "OpAdd"));
             // 转换为 OpAddMsg，复用模板版 process_msg
-            // FIXME:: 这里强制转发为 msg.name() + "_redirected",
-            OpAddMsg redirect_msg(
-                msg.name() + "_redirected",
-                msg.a(), msg.b(), msg.output()
-            );
+            const OpAddMsg redirect_msg = make_mma_redirect(msg);
             this->process_msg(redirect_msg); // 自动匹配模板版（OpAddMsg 无重载）
         } else {
-            auto processor = get_processor<OpMMAMsg>();
-            processor->process(msg); // 调用 OpMMAProcessor 逻辑
+            run_processor(msg); // 调用 OpMMAProcessor 逻辑
         }
     }
 
-    Router() {
+    explicit Router(DispatchMode mode = DispatchMode::SERIALIZED) : mode_(mode) {
         // OpAdd：模板版整合宏（一行搞定，兼容原有逻辑）
         REGISTER_MSG_HANDLER_TEMPLATE(OpAdd);
 
@@ -244,89 +424,206 @@ public:
     template <typename MsgType>
     void dispatch(const MsgType& msg) {
         // 编译期检查：事件必须继承自 MsgCRTP<MsgType>
-        PROJ_INFO("dispatch<Msg>.name = {}", msg.name());
+        PROJ_INFO_KV("dispatch", proj_logger::kv("name", msg.name()));
         static_assert(
             std::is_base_of_v<MsgCRTP<MsgType>, MsgType>,
             "MsgType must inherit from MsgCRTP<MsgType> (CRTP static polymorphism)"
         );
 
-        std::lock_guard<std::mutex> lock(mutex_); // 单线程安全保障
-        auto it = handler_map_.find(MsgType::TypeIndex());
-        if (it != handler_map_.end()) {
-            it->second(reinterpret_cast<const void*>(&msg));
+        const MsgHandler* handler = find_handler(MsgType::TypeId());
+        if (handler == nullptr) {
+            PROJ_ERRO_KV("UnsupportedMsg", proj_logger::kv("type", typeid(MsgType).name()));
+            return;
+        }
+        if (mode_ == DispatchMode::SERIALIZED) {
+            std::lock_guard<std::mutex> lock(mutex_); // 单线程处理保障
+            (*handler)(reinterpret_cast<const void*>(&msg));
         } else {
-            PROJ_ERRO("Unsupported msg type: {}", typeid(MsgType).name());
+            (*handler)(reinterpret_cast<const void*>(&msg));
         }
     }
 
-    // 通用化处理器获取（编译期类型安全）
+    // 批量分发：整批只查表、记录一次（串行模式下只加锁一次）
     template <typename MsgType>
-    std::shared_ptr<typename MsgToProcessor<MsgType>::Type> get_processor() {
-        using ProcessorType = typename MsgToProcessor<MsgType>::Type;
-        auto it = processor_map_.find(MsgType::TypeIndex());
-        if (it == processor_map_.end()) {
-            throw std::runtime_error(
-                "Processor not registered for msg: " + std::string(typeid(MsgType).name())
-            );
+    void dispatch_batch(Span<const MsgType> msgs) {
+        static_assert(
+            std::is_base_of_v<MsgCRTP<MsgType>, MsgType>,
+            "MsgType must inherit from MsgCRTP<MsgType> (CRTP static polymorphism)"
+        );
+        if (msgs.empty()) {
+            return;
+        }
+        PROJ_INFO_KV("dispatch_batch", proj_logger::kv("count", msgs.size()),
+                     proj_logger::kv("first", msgs[0].name()));
+
+        const MsgHandler* handler = find_handler(MsgType::TypeId());
+        if (handler == nullptr) {
+            PROJ_ERRO_KV("UnsupportedMsg", proj_logger::kv("type", typeid(MsgType).name()));
+            return;
         }
+        std::unique_lock<std::mutex> lock(mutex_, std::defer_lock);
+        if (mode_ == DispatchMode::SERIALIZED) {
+            lock.lock(); // 单线程处理保障
+        }
+        for (const MsgType& msg : msgs) {
+            (*handler)(reinterpret_cast<const void*>(&msg));
+        }
+    }
+
+    // 设置异步后端（如 WorkStealingExecutor，可与 ApiBase 共享）；需在 post 之前设置
+    void set_executor(std::shared_ptr<Executor> executor) {
+        std::lock_guard<std::mutex> lock(executor_mutex_);
+        executor_ = std::move(executor);
+    }
 
-        // 编译期类型转换（无运行时开销）
-        return std::any_cast<std::shared_ptr<ProcessorType>>(it->second);
+    // 设置分片执行：post 按 msg.key() 选择通道，同键消息保序、不同键并行
+    // 配合 DispatchMode::CONCURRENT 使用；串行模式下全局锁仍使处理互斥，只保留顺序语义
+    // 设置后优先于 set_executor 的后端
+    void set_sharded_executor(std::shared_ptr<ShardedExecutor> lanes) {
+        std::lock_guard<std::mutex> lock(executor_mutex_);
+        lanes_ = std::move(lanes);
     }
 
+    // 异步分发：消息不可移动，从对象池取出（或新建）后就地赋值，交给执行器由工作线程调用 dispatch
+    // 未设置执行器或执行器拒绝时在调用线程同步分发
+    template <typename MsgType, typename... Args>
+    void post(Args&&... args) {
+        auto msg = ObjectPool<MsgType>::make(std::forward<Args>(args)...);
+        const MsgType& pending = *msg;
+        std::shared_ptr<ShardedExecutor> lanes;
+        std::shared_ptr<Executor> executor;
+        {
+            std::lock_guard<std::mutex> lock(executor_mutex_);
+            lanes = lanes_;
+            executor = executor_;
+        }
+        if (lanes || executor) {
+            ExecutorTask task([this, msg = std::move(msg)]() {
+                PendingTasks::Scope finished(posted_);
+                dispatch(*msg);
+            });
+            posted_.add();
+            const bool accepted = lanes ? lanes->submit(pending.key(), std::move(task))
+                                        : executor->submit(std::move(task));
+            if (accepted) {
+                return;
+            }
+            posted_.finish();
+            // 被拒绝时任务未被移走，pending 在 task 析构前仍有效
+            PROJ_WARN_EVERY_MS(1000, "Router executor rejected msg, dispatch inline");
+            dispatch(pending);
+            return;
+        }
+        dispatch(pending);
+    }
+
+    // 等待本路由器已投递的消息分发完成（共享执行器上其他使用方的任务不在等待之列）
+    void drain() {
+        posted_.wait_idle();
+    }
+
+    // 通用化处理器获取（编译期类型安全）；处理器由路由器持有，指针在路由器生命周期内有效
+    template <typename MsgType>
+    typename MsgToProcessor<MsgType>::Type* get_processor() {
+        return &cell_of<MsgType>().processor;
+    }
+
+    DispatchMode dispatch_mode() const { return mode_; }
+
     // 语法糖：简化 OpAdd 处理器获取
-    std::shared_ptr<OpAddProcessor> get_add_processor() {
+    OpAddProcessor* get_add_processor() {
         return get_processor<OpAddMsg>();
     }
 
-    ~Router() = default; // 非虚析构
+    // 非虚析构；已投递的消息引用本对象，析构前先排空
+    ~Router() {
+        drain();
+    }
 
 private:
     // ========================== 类型别名（简化模板） ==========================
-    using MsgHandler = std::function<void(const void*)>;
-    using ProcessorMap = std::unordered_map<std::type_index, std::any>;
-    using HandlerMap = std::unordered_map<std::type_index, MsgHandler>;
+    using MsgHandler = InlineFunction<void(const void*)>;
+
+    // 路由器持有的全部处理器；每个处理器类型只能出现一次
+    using Processors = std::tuple<ProcessorCell<OpAddProcessor>, ProcessorCell<OpMMAProcessor>>;
+    using HandlerMap = std::vector<const MsgHandler*>;     // 下标为消息的稠密类型ID，指向 handler_storage_
+
+    // 不可变路由表：注册时整体复制后发布
+    struct RouteTable {
+        HandlerMap handlers;
+    };
+
+    const MsgHandler* find_handler(uint32_t id) const {
+        const RouteTable* table = table_.load();
+        return id < table->handlers.size() ? table->handlers[id] : nullptr;
+    }
+
+    // 编译期按类型取处理器单元；未关联处理器的消息类型无法通过编译
+    template <typename MsgType>
+    ProcessorCell<typename MsgToProcessor<MsgType>::Type>& cell_of() {
+        return std::get<ProcessorCell<typename MsgToProcessor<MsgType>::Type>>(processors_);
+    }
+
+    // 调用处理器：不可重入的处理器持有其专属锁
+    template <typename MsgType>
+    void run_processor(const MsgType& msg) {
+        auto& cell = cell_of<MsgType>();
+        std::lock_guard<decltype(cell.serial)> lock(cell.serial);
+        cell.processor.process(msg);
+    }
+
+    template <typename Table>
+    static typename Table::value_type& slot(Table& table, uint32_t id) {
+        if (table.size() <= id) {
+            table.resize(id + 1);
+        }
+        return table[id];
+    }
 
     // ========================== 通用注册逻辑（编译期绑定） ==========================
-    // 注册处理器（编译期类型校验）
+    // 注册处理器（纯编译期校验）：处理器本体已作为 processors_ 成员构造
     template <typename MsgType, typename ProcessorType>
-    void register_processor(std::shared_ptr<ProcessorType> processor) {
+    void register_processor() {
         static_assert(
             std::is_base_of_v<MsgCRTP<MsgType>, MsgType>,
             "MsgType must inherit from MsgCRTP<MsgType>"
         );
-
-        std::lock_guard<std::mutex> lock(mutex_); // 单线程安全保障
-        // std::any和std::unique_ptr有冲突
-        processor_map_[MsgType::TypeIndex()] = processor;
+        static_assert(
+            std::is_same_v<typename MsgToProcessor<MsgType>::Type, ProcessorType>,
+            "ProcessorType must match MsgToProcessor<MsgType>::Type"
+        );
+        (void)cell_of<MsgType>(); // 处理器必须出现在 Processors 中
     }
 
     // 注册事件处理函数（编译期绑定）
     template <typename MsgType>
     void register_handler(void (Router::*handler)(const MsgType&)) {
-        std::lock_guard<std::mutex> lock(mutex_); // 单线程安全保障
-        handler_map_[MsgType::TypeIndex()] = [this, handler](const void* msg_ptr) {
+        std::lock_guard<std::mutex> lock(mutex_); // 写者串行化
+        handler_storage_.push_back(std::make_unique<MsgHandler>([this, handler](const void* msg_ptr) {
             (this->*handler)(*static_cast<const MsgType*>(msg_ptr));
-        };
-    }
-
-    // MMA 参数校验（纯静态，无虚函数）
-    bool has_mma_param_error(const OpMMAMsg& msg) {
-        return msg.a().empty() || msg.b().empty() || msg.c().empty();
+        }));
+        auto next = std::make_unique<RouteTable>(table_.current());
+        slot(next->handlers, MsgType::TypeId()) = handler_storage_.back().get();
+        table_.publish(std::move(next));
     }
 
     // ========================== 成员变量（极简，零冗余） ==========================
-    ProcessorMap processor_map_; // 静态多态处理器注册表
-    HandlerMap handler_map_;     // 事件处理函数注册表
-    std::mutex mutex_;           // 线程安全锁（单线程处理保障）
+    const DispatchMode mode_;
+    Processors processors_;          // 静态多态处理器（编译期类型索引）
+    SnapshotPtr<RouteTable> table_;  // 当前路由表（处理函数）
+    std::vector<std::unique_ptr<MsgHandler>> handler_storage_; // 处理函数本体，地址稳定
+    std::shared_ptr<Executor> executor_; // 异步分发后端（可选）
+    std::shared_ptr<ShardedExecutor> lanes_; // 按键分片的分发通道（可选）
+    std::mutex executor_mutex_;  // 保护 executor_/lanes_，不与处理锁争用
+    PendingTasks posted_;        // 本路由器投递、尚未完成的消息
+    std::mutex mutex_;           // 注册的写锁；串行模式下兼作处理锁
 };
 
     // ========================== 统一事件处理逻辑（纯静态多态） ==========================
     // 通用事件处理（编译期绑定）
 template <typename MsgType>
 void Router::process_msg(const MsgType& msg) {
-        auto processor = get_processor<MsgType>();
-        processor->process(msg);
+        run_processor(msg);
     }
 
 } // namespace msg
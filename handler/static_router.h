@@ -0,0 +1,92 @@
+#pragma once
+#include <tuple>
+#include <type_traits>
+#include <variant>
+#include "router.h"
+
+namespace proj {
+namespace msg {
+
+// ========================== 编译期静态路由器（封闭消息集合） ==========================
+// 消息集合 Msgs... 在编译期确定，处理器按类型存放在 tuple 中
+// dispatch 直接按参数类型选择处理器：无查表、无类型擦除调用，整条路径可内联
+// 异构消息流用 MsgVariant（持有消息）或 MsgRef（引用消息），经 std::visit 分发
+// 无全局锁，语义同 Router 的 CONCURRENT 模式：仅对不可重入的处理器串行化
+template <typename... Msgs>
+class StaticRouter : public NoCopyMove {
+public:
+    // 消息不可移动：容器中需用 std::in_place_type 就地构造（如 std::deque::emplace_back）
+    using MsgVariant = std::variant<Msgs...>;
+    using MsgRef = std::variant<const Msgs*...>;
+
+    template <typename MsgType>
+    static constexpr bool kRoutes = (std::is_same_v<MsgType, Msgs> || ...);
+
+    template <typename MsgType>
+    void dispatch(const MsgType& msg) {
+        static_assert(kRoutes<MsgType>, "MsgType is not routed by this StaticRouter");
+        PROJ_INFO_KV("dispatch", proj_logger::kv("name", msg.name()));
+        route(msg);
+    }
+
+    void dispatch(const MsgVariant& msg) {
+        std::visit([this](const auto& m) { dispatch(m); }, msg);
+    }
+
+    void dispatch(const MsgRef& msg) {
+        std::visit([this](const auto* m) { dispatch(*m); }, msg);
+    }
+
+    // 批量分发：同类型消息整批直达处理器
+    template <typename MsgType>
+    void dispatch_batch(Span<const MsgType> msgs) {
+        static_assert(kRoutes<MsgType>, "MsgType is not routed by this StaticRouter");
+        if (msgs.empty()) {
+            return;
+        }
+        PROJ_INFO_KV("dispatch_batch", proj_logger::kv("count", msgs.size()),
+                     proj_logger::kv("first", msgs[0].name()));
+        for (const MsgType& msg : msgs) {
+            route(msg);
+        }
+    }
+
+    // 处理器由路由器持有，指针在路由器生命周期内有效
+    template <typename MsgType>
+    typename MsgToProcessor<MsgType>::Type* get_processor() {
+        return &cell_of<MsgType>().processor;
+    }
+
+private:
+    using Processors = std::tuple<ProcessorCell<typename MsgToProcessor<Msgs>::Type>...>;
+
+    template <typename MsgType>
+    ProcessorCell<typename MsgToProcessor<MsgType>::Type>& cell_of() {
+        return std::get<ProcessorCell<typename MsgToProcessor<MsgType>::Type>>(processors_);
+    }
+
+    template <typename MsgType>
+    void route(const MsgType& msg) {
+        auto& cell = cell_of<MsgType>();
+        std::lock_guard<decltype(cell.serial)> lock(cell.serial);
+        cell.processor.process(msg);
+    }
+
+    // OpMMA 重定向规则与 Router 一致：参数错误时改写为 OpAdd
+    void route(const OpMMAMsg& msg) {
+        static_assert(kRoutes<OpAddMsg>, "OpMMA redirect requires OpAddMsg in the same StaticRouter");
+        PROJ_INFO_KV("process_msg", proj_logger::kv("msg", "OpMMAMsg"), proj_logger::kv("name", msg.name()));
+        if (has_mma_param_error(msg)) {
+            PROJ_WARN_KV("OpMMARedirect", proj_logger::kv("name", msg.name()),
+                         proj_logger::kv("reason", "parameter error"), proj_logger::kv("to", "OpAdd"));
+            route(make_mma_redirect(msg));
+            return;
+        }
+        route<OpMMAMsg>(msg);
+    }
+
+    Processors processors_;
+};
+
+} // namespace msg
+} // namespace proj
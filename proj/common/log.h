@@ -12,4 +12,18 @@
 #define PROJ_INFO(fmt, ...) MALOG_INFO(PROJ_LOGGER_NAME, fmt, ##__VA_ARGS__)
 #define PROJ_ERRO(fmt, ...) MALOG_ERRO(PROJ_LOGGER_NAME, fmt, ##__VA_ARGS__)
 
+// 结构化版：PROJ_INFO_KV("OpAdd", proj_logger::kv("name", name), ...)
+#define PROJ_DEBG_KV(event, ...) MALOG_DEBG_KV(PROJ_LOGGER_NAME, event, ##__VA_ARGS__)
+#define PROJ_INFO_KV(event, ...) MALOG_INFO_KV(PROJ_LOGGER_NAME, event, ##__VA_ARGS__)
+#define PROJ_WARN_KV(event, ...) MALOG_WARN_KV(PROJ_LOGGER_NAME, event, ##__VA_ARGS__)
+#define PROJ_ERRO_KV(event, ...) MALOG_ERRO_KV(PROJ_LOGGER_NAME, event, ##__VA_ARGS__)
+
+// 限流版：热点调用点每N次或每ms毫秒最多输出一次，并附带被抑制的重复次数
+#define PROJ_INFO_EVERY_N(n, fmt, ...) MALOG_INFO_EVERY_N(PROJ_LOGGER_NAME, n, fmt, ##__VA_ARGS__)
+#define PROJ_WARN_EVERY_N(n, fmt, ...) MALOG_WARN_EVERY_N(PROJ_LOGGER_NAME, n, fmt, ##__VA_ARGS__)
+#define PROJ_ERRO_EVERY_N(n, fmt, ...) MALOG_ERRO_EVERY_N(PROJ_LOGGER_NAME, n, fmt, ##__VA_ARGS__)
+#define PROJ_INFO_EVERY_MS(ms, fmt, ...) MALOG_INFO_EVERY_MS(PROJ_LOGGER_NAME, ms, fmt, ##__VA_ARGS__)
+#define PROJ_WARN_EVERY_MS(ms, fmt, ...) MALOG_WARN_EVERY_MS(PROJ_LOGGER_NAME, ms, fmt, ##__VA_ARGS__)
+#define PROJ_ERRO_EVERY_MS(ms, fmt, ...) MALOG_ERRO_EVERY_MS(PROJ_LOGGER_NAME, ms, fmt, ##__VA_ARGS__)
+
 #endif // PROJ_COMMON_LOG_H
\ No newline at end of file
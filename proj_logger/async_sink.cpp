@@ -0,0 +1,159 @@
+#include "async_sink.h"
+#include <chrono>
+
+namespace proj_logger {
+
+AsyncSink::AsyncSink(std::shared_ptr<spdlog::sinks::sink> inner, size_t queue_size,
+                     OverflowPolicy policy, size_t batch_size)
+    : inner_(std::move(inner)),
+      queue_(queue_size),
+      policy_(policy),
+      batch_size_(batch_size == 0 ? 1 : batch_size) {
+    worker_ = std::thread([this]() { worker_loop(); });
+}
+
+AsyncSink::~AsyncSink() {
+    shutdown();
+}
+
+void AsyncSink::log(const spdlog::details::log_msg& msg) {
+    // 先登记为在途生产者再检查停止标志（与shutdown中的写入/读取成对使用seq_cst），
+    // shutdown要么看到本次登记并等待入队完成，要么本次看到停止标志走同步写
+    producers_.fetch_add(1, std::memory_order_seq_cst);
+    struct ProducerGuard {
+        std::atomic<uint32_t>& count;
+        ~ProducerGuard() { count.fetch_sub(1, std::memory_order_release); }
+    } guard{producers_};
+
+    // 已停止：退化为同步写，保证静态析构阶段的日志不丢失
+    if (stopping_.load(std::memory_order_seq_cst)) {
+        inner_->log(msg);
+        written_.fetch_add(1, std::memory_order_relaxed);
+        return;
+    }
+
+    spdlog::details::log_msg_buffer buffered(msg);
+    while (!queue_.try_push(std::move(buffered))) {
+        if (policy_ == OverflowPolicy::DROP_NEWEST) {
+            dropped_.fetch_add(1, std::memory_order_relaxed);
+            return;
+        }
+        if (policy_ == OverflowPolicy::DROP_OLDEST) {
+            spdlog::details::log_msg_buffer oldest;
+            if (queue_.try_pop(oldest)) {
+                dropped_.fetch_add(1, std::memory_order_relaxed);
+            }
+            continue;
+        }
+        // BLOCK：停止过程中后台线程可能已退出，不再等待空位，直接同步写
+        if (stopping_.load(std::memory_order_acquire)) {
+            inner_->log(buffered);
+            written_.fetch_add(1, std::memory_order_relaxed);
+            return;
+        }
+        // 唤醒后台线程并让出CPU，直到有空位
+        wake_worker();
+        std::this_thread::yield();
+    }
+    wake_worker();
+}
+
+void AsyncSink::wake_worker() {
+    // 与worker_loop中sleeping_的写入配对，避免丢失唤醒
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    if (sleeping_.load(std::memory_order_relaxed)) {
+        { std::lock_guard<std::mutex> lock(wait_mutex_); }
+        wait_cv_.notify_one();
+    }
+}
+
+void AsyncSink::worker_loop() {
+    spdlog::details::log_msg_buffer msg;
+    for (;;) {
+        busy_.store(true, std::memory_order_seq_cst);
+        size_t count = 0;
+        while (count < batch_size_ && queue_.try_pop(msg)) {
+            inner_->log(msg);
+            ++count;
+        }
+        if (count > 0) {
+            // 一个批次只flush一次
+            inner_->flush();
+            written_.fetch_add(count, std::memory_order_relaxed);
+            continue;
+        }
+        busy_.store(false, std::memory_order_seq_cst);
+
+        if (stopping_.load(std::memory_order_acquire) && queue_.empty_approx()) {
+            return;
+        }
+
+        std::unique_lock<std::mutex> lock(wait_mutex_);
+        sleeping_.store(true, std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        wait_cv_.wait_for(lock, std::chrono::milliseconds(50), [this]() {
+            return !queue_.empty_approx() || stopping_.load(std::memory_order_acquire);
+        });
+        sleeping_.store(false, std::memory_order_relaxed);
+    }
+}
+
+void AsyncSink::flush() {
+    if (stopping_.load(std::memory_order_acquire)) {
+        inner_->flush();
+        return;
+    }
+    wake_worker();
+    while (!queue_.empty_approx() || busy_.load(std::memory_order_seq_cst)) {
+        std::this_thread::yield();
+    }
+    inner_->flush();
+}
+
+void AsyncSink::set_pattern(const std::string& pattern) {
+    inner_->set_pattern(pattern);
+}
+
+void AsyncSink::set_formatter(std::unique_ptr<spdlog::formatter> sink_formatter) {
+    inner_->set_formatter(std::move(sink_formatter));
+}
+
+void AsyncSink::shutdown() {
+    std::lock_guard<std::mutex> lock(shutdown_mutex_);
+    if (stopped_.load(std::memory_order_acquire)) {
+        return;
+    }
+    stopping_.store(true, std::memory_order_seq_cst);
+    {
+        std::lock_guard<std::mutex> wait_lock(wait_mutex_);
+    }
+    wait_cv_.notify_one();
+    if (worker_.joinable()) {
+        worker_.join();
+    }
+
+    // 等待停止标志生效前已进入 log() 的生产者完成入队，之后队列不再增长
+    while (producers_.load(std::memory_order_seq_cst) != 0) {
+        std::this_thread::yield();
+    }
+
+    // 兜底：写出后台线程退出后才入队的消息
+    spdlog::details::log_msg_buffer msg;
+    while (queue_.try_pop(msg)) {
+        inner_->log(msg);
+        written_.fetch_add(1, std::memory_order_relaxed);
+    }
+    inner_->flush();
+    stopped_.store(true, std::memory_order_release);
+}
+
+AsyncSinkStats AsyncSink::stats() const {
+    AsyncSinkStats result;
+    result.written = written_.load(std::memory_order_relaxed);
+    result.dropped = dropped_.load(std::memory_order_relaxed);
+    result.queue_depth = queue_.size_approx();
+    result.queue_capacity = queue_.capacity();
+    return result;
+}
+
+} // namespace proj_logger
@@ -0,0 +1,80 @@
+// async_sink.h
+#ifndef PROJ_ASYNC_SINK_H
+#define PROJ_ASYNC_SINK_H
+
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <spdlog/sinks/sink.h>
+#include <spdlog/details/log_msg_buffer.h>
+#include "enum_base.h"
+#include "bounded_queue.h"
+
+namespace proj_logger {
+
+// 队列满时的处理策略
+#define OVERFLOW_POLICY_ITEMS(macro) \
+    macro(BLOCK) \
+    macro(DROP_NEWEST) \
+    macro(DROP_OLDEST)
+
+DEFINE_PROJ_ENUM(OverflowPolicy, OVERFLOW_POLICY_ITEMS)
+
+// 异步sink运行统计
+struct AsyncSinkStats {
+    uint64_t written = 0;      // 已写入下游sink的条数
+    uint64_t dropped = 0;      // 因队列满被丢弃的条数
+    size_t queue_depth = 0;    // 当前队列深度（近似值）
+    size_t queue_capacity = 0; // 队列容量
+};
+
+// 异步批量sink：调用线程只做消息拷贝+入队，后台线程批量写入下游sink并统一flush
+class AsyncSink : public spdlog::sinks::sink {
+public:
+    AsyncSink(std::shared_ptr<spdlog::sinks::sink> inner, size_t queue_size,
+              OverflowPolicy policy, size_t batch_size = 256);
+    ~AsyncSink() override;
+
+    AsyncSink(const AsyncSink&) = delete;
+    AsyncSink& operator=(const AsyncSink&) = delete;
+
+    void log(const spdlog::details::log_msg& msg) override;
+    // 等待队列中已有消息全部写出后flush下游
+    void flush() override;
+    void set_pattern(const std::string& pattern) override;
+    void set_formatter(std::unique_ptr<spdlog::formatter> sink_formatter) override;
+
+    // 排空队列并停止后台线程：等待在途的 log() 入队完成后写出全部剩余消息；之后的日志同步写入下游
+    void shutdown();
+
+    AsyncSinkStats stats() const;
+
+private:
+    void worker_loop();
+    void wake_worker();
+
+    std::shared_ptr<spdlog::sinks::sink> inner_;
+    BoundedMPMCQueue<spdlog::details::log_msg_buffer> queue_;
+    const OverflowPolicy policy_;
+    const size_t batch_size_;
+
+    std::atomic<uint64_t> written_{0};
+    std::atomic<uint64_t> dropped_{0};
+    std::atomic<uint32_t> producers_{0}; // 正在 log() 中入队的生产者数
+    std::atomic<bool> busy_{false};      // 后台线程正在处理批次
+    std::atomic<bool> sleeping_{false};  // 后台线程正在等待
+    std::atomic<bool> stopping_{false};
+    std::atomic<bool> stopped_{false};
+
+    std::mutex wait_mutex_;
+    std::condition_variable wait_cv_;
+    std::mutex shutdown_mutex_;
+    std::thread worker_;
+};
+
+} // namespace proj_logger
+
+#endif // PROJ_ASYNC_SINK_H
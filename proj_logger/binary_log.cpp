@@ -0,0 +1,442 @@
+#include "binary_log.h"
+#include "proj_logger.h"
+#include <cstdlib>
+#include <ctime>
+#include <deque>
+#include <iterator>
+#include <spdlog/details/log_msg.h>
+#if defined(SPDLOG_FMT_EXTERNAL)
+#include <fmt/args.h>
+#else
+#include <spdlog/fmt/bundled/args.h>
+#endif
+
+namespace proj_logger {
+
+// ===================== 调用点注册表 =====================
+namespace binary_detail {
+
+struct SiteStorage {
+    LogLevel level;
+    int line;
+    std::string logger;
+    std::string file;
+    std::string fmt;
+    bool structured;
+};
+
+// 注意：状态放在外部链接的函数内，保证多个动态库共享同一份
+std::deque<SiteStorage>& site_storage(std::mutex*& mutex) {
+    static std::mutex site_mutex;
+    static std::deque<SiteStorage> sites;
+    mutex = &site_mutex;
+    return sites;
+}
+
+} // namespace binary_detail
+
+namespace {
+
+using binary_detail::SiteStorage;
+
+// 二进制文件格式：魔数 + 帧序列
+// 'S' 调用点帧：id, level, line, logger, file, fmt, structured(uint8)
+// 'R' 记录帧：线程号, 负载长度, 负载（调用点ID + 时间戳 + 参数）
+// 版本1的调用点帧没有 structured 字段，解码时按非结构化处理
+constexpr char kFileMagic[8] = {'P', 'L', 'O', 'G', 'B', 'I', 'N', '2'};
+constexpr char kFileMagicV1[8] = {'P', 'L', 'O', 'G', 'B', 'I', 'N', '1'};
+constexpr uint8_t kSiteFrame = 'S';
+constexpr uint8_t kRecordFrame = 'R';
+
+template <typename T>
+bool read_pod(const uint8_t*& p, const uint8_t* end, T& value) {
+    if (static_cast<size_t>(end - p) < sizeof(T)) return false;
+    std::memcpy(&value, p, sizeof(T));
+    p += sizeof(T);
+    return true;
+}
+
+template <typename T>
+void write_pod(FILE* file, const T& value) {
+    std::fwrite(&value, sizeof(T), 1, file);
+}
+
+template <typename T>
+bool read_pod(FILE* file, T& value) {
+    return std::fread(&value, sizeof(T), 1, file) == 1;
+}
+
+template <typename LenType>
+void write_str(FILE* file, const char* s) {
+    LenType len = static_cast<LenType>(std::strlen(s));
+    write_pod(file, len);
+    std::fwrite(s, 1, len, file);
+}
+
+template <typename LenType>
+bool read_str(FILE* file, std::string& s) {
+    LenType len;
+    if (!read_pod(file, len)) return false;
+    s.resize(len);
+    return len == 0 || std::fread(&s[0], 1, len, file) == len;
+}
+
+const char* basename_of(const char* path) {
+    const char* slash = std::strrchr(path, '/');
+    return slash ? slash + 1 : path;
+}
+
+} // namespace
+
+uint32_t register_log_site(const char* logger, LogLevel level, const char* file, int line, const char* fmt,
+                           bool structured) {
+    std::mutex* mutex = nullptr;
+    auto& sites = binary_detail::site_storage(mutex);
+    std::lock_guard<std::mutex> lock(*mutex);
+    sites.push_back(SiteStorage{level, line, logger, file, fmt, structured});
+    return static_cast<uint32_t>(sites.size() - 1);
+}
+
+bool find_log_site(uint32_t id, LogSite& out) {
+    std::mutex* mutex = nullptr;
+    auto& sites = binary_detail::site_storage(mutex);
+    std::lock_guard<std::mutex> lock(*mutex);
+    if (id >= sites.size()) {
+        return false;
+    }
+    const SiteStorage& site = sites[id];
+    out = LogSite{site.level, site.line, site.logger.c_str(), site.file.c_str(), site.fmt.c_str(), site.structured};
+    return true;
+}
+
+// ===================== 调用线程侧 =====================
+namespace binary_detail {
+
+std::atomic<bool> enabled{false};
+
+std::atomic<uint64_t>& dropped_counter() {
+    static std::atomic<uint64_t> dropped{0};
+    return dropped;
+}
+
+ThreadRingRegistry& rings() {
+    static ThreadRingRegistry registry([]() -> size_t {
+        const char* env_val = std::getenv("PROJ_LOG_BINARY_RING");
+        long long bytes = env_val ? std::atoll(env_val) : 0;
+        return bytes > 0 ? static_cast<size_t>(bytes) : (1u << 20);
+    }());
+    return registry;
+}
+
+SpscByteRing& local_ring() {
+    // 缓存本线程的环，稳态下只有一次线程本地变量读取
+    thread_local SpscByteRing* ring = &rings().local_ring();
+    return *ring;
+}
+
+void note_dropped() {
+    dropped_counter().fetch_add(1, std::memory_order_relaxed);
+}
+
+StripedCounter& writers() {
+    static StripedCounter counter;
+    return counter;
+}
+
+} // namespace binary_detail
+
+// ===================== 格式化/解码 =====================
+bool format_binary_message(const LogSite& site, const uint8_t* args, size_t len, std::string& out) {
+    fmt::dynamic_format_arg_store<fmt::format_context> store;
+    const uint8_t* p = args;
+    const uint8_t* end = args + len;
+    while (p < end) {
+        const auto tag = static_cast<BinaryArgTag>(*p++);
+        switch (tag) {
+            case BinaryArgTag::I64: {
+                int64_t v;
+                if (!read_pod(p, end, v)) return false;
+                store.push_back(v);
+                break;
+            }
+            case BinaryArgTag::U64: {
+                uint64_t v;
+                if (!read_pod(p, end, v)) return false;
+                store.push_back(v);
+                break;
+            }
+            case BinaryArgTag::F64: {
+                double v;
+                if (!read_pod(p, end, v)) return false;
+                store.push_back(v);
+                break;
+            }
+            case BinaryArgTag::BOOL: {
+                uint8_t v;
+                if (!read_pod(p, end, v)) return false;
+                store.push_back(v != 0);
+                break;
+            }
+            case BinaryArgTag::CHAR: {
+                char v;
+                if (!read_pod(p, end, v)) return false;
+                store.push_back(v);
+                break;
+            }
+            case BinaryArgTag::STR: {
+                uint32_t n;
+                if (!read_pod(p, end, n) || static_cast<size_t>(end - p) < n) return false;
+                // 字符串视图指向环内数据，格式化完成前不会释放
+                store.push_back(fmt::string_view(reinterpret_cast<const char*>(p), n));
+                p += n;
+                break;
+            }
+            case BinaryArgTag::PTR: {
+                uint64_t v;
+                if (!read_pod(p, end, v)) return false;
+                store.push_back(reinterpret_cast<const void*>(static_cast<uintptr_t>(v)));
+                break;
+            }
+            default:
+                return false;
+        }
+    }
+
+    out.clear();
+    try {
+        fmt::vformat_to(std::back_inserter(out), fmt::string_view(site.fmt), store);
+    } catch (const std::exception& e) {
+        out = std::string(site.fmt) + " [format error: " + e.what() + "]";
+    }
+    return true;
+}
+
+long decode_binary_log_file(const std::string& path, FILE* out, bool json) {
+    FILE* file = std::fopen(path.c_str(), "rb");
+    if (file == nullptr) {
+        return -1;
+    }
+    char magic[sizeof(kFileMagic)];
+    if (std::fread(magic, 1, sizeof(magic), file) != sizeof(magic) ||
+        (std::memcmp(magic, kFileMagic, sizeof(magic)) != 0 &&
+         std::memcmp(magic, kFileMagicV1, sizeof(magic)) != 0)) {
+        std::fclose(file);
+        return -1;
+    }
+    const bool has_structured_flag = std::memcmp(magic, kFileMagic, sizeof(magic)) == 0;
+    JsonLineFormatter json_formatter;
+    spdlog::memory_buf_t json_buf;
+
+    std::vector<SiteStorage> sites;
+    std::vector<uint8_t> payload;
+    std::string text;
+    long count = 0;
+    uint8_t frame;
+    while (read_pod(file, frame)) {
+        if (frame == kSiteFrame) {
+            uint32_t id;
+            int32_t level, line;
+            uint8_t structured = 0;
+            SiteStorage site;
+            if (!read_pod(file, id) || !read_pod(file, level) || !read_pod(file, line) ||
+                !read_str<uint16_t>(file, site.logger) || !read_str<uint16_t>(file, site.file) ||
+                !read_str<uint32_t>(file, site.fmt) || (has_structured_flag && !read_pod(file, structured))) {
+                break;
+            }
+            site.level = static_cast<LogLevel>(level);
+            site.line = line;
+            site.structured = structured != 0;
+            if (sites.size() <= id) sites.resize(id + 1);
+            sites[id] = std::move(site);
+        } else if (frame == kRecordFrame) {
+            uint64_t thread_id;
+            uint32_t len;
+            if (!read_pod(file, thread_id) || !read_pod(file, len)) break;
+            payload.resize(len);
+            if (len > 0 && std::fread(payload.data(), 1, len, file) != len) break;
+
+            const uint8_t* p = payload.data();
+            const uint8_t* end = p + len;
+            uint32_t site_id;
+            int64_t ts;
+            if (!read_pod(p, end, site_id) || !read_pod(p, end, ts) || site_id >= sites.size()) continue;
+            const SiteStorage& s = sites[site_id];
+            LogSite site{s.level, s.line, s.logger.c_str(), s.file.c_str(), s.fmt.c_str(), s.structured};
+            if (!format_binary_message(site, p, static_cast<size_t>(end - p), text)) continue;
+
+            if (json) {
+                // 与 PROJ_LOG_FORMAT=json 一致：结构化调用点带结构化标记，字段并入对象
+                const auto log_time = spdlog::log_clock::time_point(
+                    std::chrono::duration_cast<spdlog::log_clock::duration>(std::chrono::nanoseconds(ts)));
+                spdlog::details::log_msg msg(
+                    log_time, spdlog::source_loc(site.file, site.line, site.structured ? kStructuredFuncname : ""),
+                    site.logger, to_spdlog_level(site.level), text);
+                msg.thread_id = static_cast<size_t>(thread_id);
+                json_buf.clear();
+                json_formatter.format(msg, json_buf);
+                std::fwrite(json_buf.data(), 1, json_buf.size(), out);
+                ++count;
+                continue;
+            }
+
+            // 与文本模式一致：[%Y-%m-%d %H:%M:%S.%e] [%n] [%l] [%s:%#] %v
+            std::time_t secs = static_cast<std::time_t>(ts / 1000000000);
+            std::tm tm_buf;
+            localtime_r(&secs, &tm_buf);
+            char time_str[32];
+            std::strftime(time_str, sizeof(time_str), "%Y-%m-%d %H:%M:%S", &tm_buf);
+            auto level_name = spdlog::level::to_string_view(to_spdlog_level(site.level));
+            std::fprintf(out, "[%s.%03d] [%s] [%.*s] [%s:%d] %s\n", time_str,
+                         static_cast<int>((ts / 1000000) % 1000), site.logger,
+                         static_cast<int>(level_name.size()), level_name.data(),
+                         basename_of(site.file), site.line, text.c_str());
+            ++count;
+        } else {
+            break; // 未知帧：文件损坏或被截断
+        }
+    }
+    std::fclose(file);
+    return count;
+}
+
+// ===================== 后台线程 =====================
+BinaryLogBackend::BinaryLogBackend(std::shared_ptr<spdlog::sinks::sink> sink, const std::string& output_path)
+    : sink_(std::move(sink)) {
+    if (!output_path.empty()) {
+        file_ = std::fopen(output_path.c_str(), "wb");
+        if (file_ != nullptr) {
+            std::setvbuf(file_, nullptr, _IOFBF, 1 << 20);
+            std::fwrite(kFileMagic, 1, sizeof(kFileMagic), file_);
+        }
+    }
+    binary_detail::enabled.store(true, std::memory_order_release);
+    worker_ = std::thread([this]() { worker_loop(); });
+}
+
+BinaryLogBackend::~BinaryLogBackend() {
+    shutdown();
+}
+
+uint64_t BinaryLogBackend::dropped() {
+    return binary_detail::dropped_counter().load(std::memory_order_relaxed);
+}
+
+void BinaryLogBackend::shutdown() {
+    binary_detail::enabled.store(false, std::memory_order_seq_cst);
+    if (stopping_.exchange(true)) {
+        return;
+    }
+    if (worker_.joinable()) {
+        worker_.join();
+    }
+    // 等待关闭前已登记的写者提交完成，之后的写入都被拒绝，环不再增长
+    while (!binary_detail::writers().is_zero()) {
+        std::this_thread::yield();
+    }
+    flush();
+    if (file_ != nullptr) {
+        std::fclose(file_);
+        file_ = nullptr;
+    }
+}
+
+void BinaryLogBackend::flush() {
+    while (drain_once() > 0) {
+    }
+    std::lock_guard<std::mutex> lock(drain_mutex_);
+    if (file_ != nullptr) {
+        std::fflush(file_);
+    } else if (sink_) {
+        sink_->flush();
+    }
+}
+
+void BinaryLogBackend::worker_loop() {
+    while (!stopping_.load(std::memory_order_acquire)) {
+        if (drain_once() == 0) {
+            // 调用线程不做唤醒（保持热路径最短），空闲时短暂休眠轮询
+            std::this_thread::sleep_for(std::chrono::milliseconds(1));
+        }
+    }
+}
+
+size_t BinaryLogBackend::drain_once() {
+    std::lock_guard<std::mutex> lock(drain_mutex_);
+    binary_detail::rings().collect(rings_);
+    size_t count = 0;
+    for (auto& entry : rings_) {
+        size_t len = 0;
+        while (const uint8_t* record = entry->ring.peek(len)) {
+            const uint8_t* p = record;
+            const uint8_t* end = record + len;
+            uint32_t site_id;
+            int64_t ts;
+            if (read_pod(p, end, site_id) && read_pod(p, end, ts)) {
+                if (file_ != nullptr) {
+                    const LogSite* s = site(site_id);
+                    if (s != nullptr) {
+                        write_site_frame(site_id, *s);
+                        write_pod(file_, kRecordFrame);
+                        write_pod(file_, entry->thread_id);
+                        write_pod(file_, static_cast<uint32_t>(len));
+                        std::fwrite(record, 1, len, file_);
+                    }
+                } else if (const LogSite* s = site(site_id)) {
+                    emit(*s, entry->thread_id, ts, p, static_cast<size_t>(end - p));
+                }
+            }
+            entry->ring.release();
+            ++count;
+        }
+    }
+    if (count > 0 && file_ == nullptr && sink_) {
+        sink_->flush();
+    }
+    return count;
+}
+
+const LogSite* BinaryLogBackend::site(uint32_t id) {
+    if (id >= sites_.size()) {
+        sites_.resize(id + 1, LogSite{LogLevel::OFF, 0, nullptr, nullptr, nullptr});
+        sites_written_.resize(id + 1, false);
+    }
+    if (sites_[id].fmt == nullptr && !find_log_site(id, sites_[id])) {
+        return nullptr;
+    }
+    return &sites_[id];
+}
+
+void BinaryLogBackend::write_site_frame(uint32_t id, const LogSite& site) {
+    if (sites_written_[id]) {
+        return;
+    }
+    write_pod(file_, kSiteFrame);
+    write_pod(file_, id);
+    write_pod(file_, static_cast<int32_t>(site.level));
+    write_pod(file_, static_cast<int32_t>(site.line));
+    write_str<uint16_t>(file_, site.logger);
+    write_str<uint16_t>(file_, site.file);
+    write_str<uint32_t>(file_, site.fmt);
+    write_pod(file_, static_cast<uint8_t>(site.structured ? 1 : 0));
+    sites_written_[id] = true;
+}
+
+void BinaryLogBackend::emit(const LogSite& site, uint64_t thread_id, int64_t ts,
+                            const uint8_t* args, size_t len) {
+    if (!format_binary_message(site, args, len, text_)) {
+        return;
+    }
+    const auto level = to_spdlog_level(site.level);
+    if (!sink_ || !sink_->should_log(level)) {
+        return;
+    }
+    const auto log_time = spdlog::log_clock::time_point(
+        std::chrono::duration_cast<spdlog::log_clock::duration>(std::chrono::nanoseconds(ts)));
+    spdlog::details::log_msg msg(log_time,
+                                 spdlog::source_loc(site.file, site.line, site.structured ? kStructuredFuncname : ""),
+                                 site.logger, level, text_);
+    msg.thread_id = static_cast<size_t>(thread_id);
+    sink_->log(msg);
+}
+
+} // namespace proj_logger
@@ -0,0 +1,227 @@
+// binary_log.h
+#ifndef PROJ_BINARY_LOG_H
+#define PROJ_BINARY_LOG_H
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <type_traits>
+#include <vector>
+#include <spdlog/fmt/fmt.h>
+#include <spdlog/sinks/sink.h>
+#include "enum_base.h"
+#include "thread_ring.h"
+#include "striped_counter.h"
+
+// 二进制日志（延迟格式化）：
+// 调用点只记录 调用点ID + 时间戳 + 原始参数字节 到本线程的SPSC环，
+// 格式化由后台线程完成，或写入二进制文件后由 proj_log_decode 离线解码
+namespace proj_logger {
+
+enum class LogLevel : int32_t;
+
+// 调用点静态描述（首次调用时注册，之后只传ID）
+struct LogSite {
+    LogLevel level;
+    int line;
+    const char* logger;
+    const char* file;
+    const char* fmt;
+    bool structured = false;  // 结构化日志调用点（正文为JSON对象），随调用点帧写入二进制文件
+};
+
+uint32_t register_log_site(const char* logger, LogLevel level, const char* file, int line, const char* fmt,
+                           bool structured = false);
+// 按ID查找调用点（加锁，仅消费者/解码使用）
+bool find_log_site(uint32_t id, LogSite& out);
+
+// 参数类型标签
+enum class BinaryArgTag : uint8_t {
+    I64 = 1,
+    U64,
+    F64,
+    BOOL,
+    CHAR,
+    STR,
+    PTR,
+};
+
+// 记录头：调用点ID + 时间戳（system_clock纳秒）
+constexpr size_t kBinaryRecordHeaderSize = sizeof(uint32_t) + sizeof(int64_t);
+
+namespace binary_detail {
+
+extern std::atomic<bool> enabled;
+
+template <typename T>
+constexpr bool is_string_like_v = std::is_convertible_v<const T&, std::string_view>;
+
+template <typename T>
+constexpr bool is_encodable_v =
+    std::is_arithmetic_v<T> || is_string_like_v<T> || std::is_pointer_v<T>;
+
+inline std::string_view as_string_view(const char* s) { return s ? std::string_view(s) : std::string_view(); }
+template <typename T>
+std::string_view as_string_view(const T& s) { return std::string_view(s); }
+
+template <typename T>
+size_t arg_size(const T& value) {
+    if constexpr (std::is_same_v<T, bool> || std::is_same_v<T, char>) {
+        return 1 + 1;
+    } else if constexpr (std::is_arithmetic_v<T>) {
+        return 1 + 8;
+    } else if constexpr (is_string_like_v<T>) {
+        return 1 + sizeof(uint32_t) + as_string_view(value).size();
+    } else {
+        return 1 + 8; // 指针
+    }
+}
+
+inline void put(uint8_t*& p, const void* data, size_t n) {
+    std::memcpy(p, data, n);
+    p += n;
+}
+
+template <typename T>
+void write_arg(uint8_t*& p, const T& value) {
+    if constexpr (std::is_same_v<T, bool>) {
+        *p++ = static_cast<uint8_t>(BinaryArgTag::BOOL);
+        *p++ = value ? 1 : 0;
+    } else if constexpr (std::is_same_v<T, char>) {
+        *p++ = static_cast<uint8_t>(BinaryArgTag::CHAR);
+        *p++ = static_cast<uint8_t>(value);
+    } else if constexpr (std::is_floating_point_v<T>) {
+        *p++ = static_cast<uint8_t>(BinaryArgTag::F64);
+        double v = static_cast<double>(value);
+        put(p, &v, sizeof(v));
+    } else if constexpr (std::is_integral_v<T> && std::is_signed_v<T>) {
+        *p++ = static_cast<uint8_t>(BinaryArgTag::I64);
+        int64_t v = static_cast<int64_t>(value);
+        put(p, &v, sizeof(v));
+    } else if constexpr (std::is_integral_v<T>) {
+        *p++ = static_cast<uint8_t>(BinaryArgTag::U64);
+        uint64_t v = static_cast<uint64_t>(value);
+        put(p, &v, sizeof(v));
+    } else if constexpr (is_string_like_v<T>) {
+        *p++ = static_cast<uint8_t>(BinaryArgTag::STR);
+        std::string_view sv = as_string_view(value);
+        uint32_t len = static_cast<uint32_t>(sv.size());
+        put(p, &len, sizeof(len));
+        put(p, sv.data(), sv.size());
+    } else {
+        *p++ = static_cast<uint8_t>(BinaryArgTag::PTR);
+        uint64_t v = reinterpret_cast<uintptr_t>(value);
+        put(p, &v, sizeof(v));
+    }
+}
+
+// 二进制记录所用的线程环注册表（PROJ_LOG_BINARY_RING 指定每线程环字节数）
+ThreadRingRegistry& rings();
+SpscByteRing& local_ring();
+void note_dropped();
+// 正在写环的调用线程（分条计数）：shutdown 等其归零后再最后排空
+StripedCounter& writers();
+
+} // namespace binary_detail
+
+inline bool binary_log_enabled() {
+    return binary_detail::enabled.load(std::memory_order_relaxed);
+}
+
+// 可直接编码的参数原样透传；其他类型在调用点先格式化为字符串
+template <typename T>
+std::enable_if_t<binary_detail::is_encodable_v<T>, const T&> binary_arg(const T& value) {
+    return value;
+}
+
+template <typename T>
+std::enable_if_t<!binary_detail::is_encodable_v<T>, std::string> binary_arg(const T& value) {
+    return fmt::format("{}", value);
+}
+
+template <typename... Ps>
+void binary_log_prepared(uint32_t site_id, const Ps&... ps) {
+    // 先登记为在途写者再复查开关（均为seq_cst）：shutdown 要么等本次提交完成后再排空，
+    // 要么本次看到已关闭——调用点检查开关之后后台才关闭的记录计为丢弃，不会无声丢失
+    StripedCounter::Slot& slot = binary_detail::writers().enter();
+    struct WriterGuard {
+        StripedCounter::Slot& slot;
+        ~WriterGuard() { StripedCounter::leave(slot); }
+    } guard{slot};
+    if (!binary_detail::enabled.load(std::memory_order_seq_cst)) {
+        binary_detail::note_dropped();
+        return;
+    }
+
+    const size_t size = kBinaryRecordHeaderSize + (size_t(0) + ... + binary_detail::arg_size(ps));
+    SpscByteRing& ring = binary_detail::local_ring();
+    uint8_t* p = ring.reserve(size);
+    if (p == nullptr) {
+        binary_detail::note_dropped(); // 环满：丢弃，不阻塞调用线程
+        return;
+    }
+    const int64_t ts = std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::system_clock::now().time_since_epoch()).count();
+    binary_detail::put(p, &site_id, sizeof(site_id));
+    binary_detail::put(p, &ts, sizeof(ts));
+    (binary_detail::write_arg(p, ps), ...);
+    ring.commit();
+}
+
+template <typename... Args>
+void binary_log(uint32_t site_id, const Args&... args) {
+    binary_log_prepared(site_id, binary_arg(args)...);
+}
+
+// 将参数字节按调用点格式串格式化到out（后台线程与离线解码共用）
+bool format_binary_message(const LogSite& site, const uint8_t* args, size_t len, std::string& out);
+
+// 离线解码二进制日志文件并以文本格式输出（json为true时按JSON行格式输出），返回解码的记录数，文件无效返回-1
+long decode_binary_log_file(const std::string& path, FILE* out, bool json = false);
+
+// 二进制日志后台：排空各线程的环，格式化写入sink，或写出原始二进制文件
+class BinaryLogBackend {
+public:
+    // output_path为空：格式化后写入sink；否则写二进制文件（sink不使用）
+    BinaryLogBackend(std::shared_ptr<spdlog::sinks::sink> sink, const std::string& output_path);
+    ~BinaryLogBackend();
+
+    BinaryLogBackend(const BinaryLogBackend&) = delete;
+    BinaryLogBackend& operator=(const BinaryLogBackend&) = delete;
+
+    // 关闭二进制模式，排空所有环后停止后台线程
+    void shutdown();
+    // 同步排空当前已提交的记录
+    void flush();
+
+    static uint64_t dropped();
+
+private:
+    void worker_loop();
+    size_t drain_once();
+    const LogSite* site(uint32_t id);
+    void emit(const LogSite& site, uint64_t thread_id, int64_t ts, const uint8_t* args, size_t len);
+    void write_site_frame(uint32_t id, const LogSite& site);
+
+    std::shared_ptr<spdlog::sinks::sink> sink_;
+    FILE* file_ = nullptr;
+    std::vector<LogSite> sites_;       // 调用点本地缓存（仅后台线程访问）
+    std::vector<bool> sites_written_;  // 已写入文件的调用点
+    std::vector<std::shared_ptr<ThreadRingRegistry::Entry>> rings_;
+    std::string text_;
+
+    std::mutex drain_mutex_;           // flush与后台线程互斥排空
+    std::atomic<bool> stopping_{false};
+    std::thread worker_;
+};
+
+} // namespace proj_logger
+
+#endif // PROJ_BINARY_LOG_H
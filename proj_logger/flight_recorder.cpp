@@ -0,0 +1,303 @@
+#include "flight_recorder.h"
+#include <algorithm>
+#include <chrono>
+#include <csignal>
+#include <cstring>
+#include <ctime>
+#include <vector>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <unistd.h>
+
+namespace proj_logger {
+
+namespace {
+
+constexpr char kFlightMagic[8] = {'P', 'L', 'O', 'G', 'F', 'L', 'T', '1'};
+constexpr uint64_t kSlotBusy = ~static_cast<uint64_t>(0);
+constexpr int kFatalSignals[] = {SIGSEGV, SIGBUS, SIGFPE, SIGILL, SIGABRT};
+constexpr size_t kFatalSignalCount = sizeof(kFatalSignals) / sizeof(kFatalSignals[0]);
+
+struct sigaction g_previous_actions[kFatalSignalCount];
+
+size_t round_up_pow2(size_t n) {
+    size_t v = 1;
+    while (v < n) v <<= 1;
+    return v;
+}
+
+const char* basename_of(const char* path) {
+    if (path == nullptr) return "";
+    const char* slash = std::strrchr(path, '/');
+    return slash ? slash + 1 : path;
+}
+
+// 截断拷贝并保证以'\0'结尾
+template <size_t N>
+void copy_truncated(char (&dst)[N], const char* src, size_t len) {
+    len = std::min(len, N - 1);
+    std::memcpy(dst, src, len);
+    dst[len] = '\0';
+}
+
+// 行缓冲：只用栈内存和手写的数字转换，可在信号处理函数中使用
+struct LineBuffer {
+    char data[kFlightSlotSize + 192];
+    size_t size = 0;
+
+    void append(const char* s, size_t n) {
+        n = std::min(n, sizeof(data) - size);
+        std::memcpy(data + size, s, n);
+        size += n;
+    }
+    void append(const char* s) { append(s, std::strlen(s)); }
+    void append_uint(uint64_t v, int width = 0) {
+        char digits[24];
+        int n = 0;
+        do {
+            digits[n++] = static_cast<char>('0' + v % 10);
+            v /= 10;
+        } while (v != 0);
+        while (n < width) digits[n++] = '0';
+        while (n > 0) append(&digits[--n], 1);
+    }
+};
+
+// 与文本模式一致：[%Y-%m-%d %H:%M:%S.%e] [%n] [%l] [%s:%#] %v
+// signal_safe 时不调用 localtime_r，时间输出为 epoch秒.毫秒
+void format_record(const FlightRecord& rec, bool signal_safe, LineBuffer& line) {
+    const int64_t secs = rec.time_ns / 1000000000;
+    const int64_t millis = (rec.time_ns / 1000000) % 1000;
+    line.append("[");
+    if (signal_safe) {
+        line.append_uint(static_cast<uint64_t>(secs));
+    } else {
+        std::time_t t = static_cast<std::time_t>(secs);
+        std::tm tm_buf;
+        localtime_r(&t, &tm_buf);
+        char time_str[32];
+        line.append(time_str, std::strftime(time_str, sizeof(time_str), "%Y-%m-%d %H:%M:%S", &tm_buf));
+    }
+    line.append(".");
+    line.append_uint(static_cast<uint64_t>(millis), 3);
+    line.append("] [");
+    line.append(rec.logger);
+    line.append("] [");
+    auto level_name = spdlog::level::to_string_view(static_cast<spdlog::level::level_enum>(rec.level));
+    line.append(level_name.data(), level_name.size());
+    line.append("] [");
+    line.append(rec.file);
+    line.append(":");
+    line.append_uint(static_cast<uint64_t>(std::max(rec.line, 0)));
+    line.append("] ");
+    line.append(rec.text, std::min<size_t>(rec.text_len, sizeof(rec.text)));
+    line.append("\n");
+}
+
+// 读取序号为ticket的记录；槽位已被覆盖或正在写入时返回false
+bool read_slot(const FlightSlot& slot, uint64_t ticket, FlightRecord& out) {
+    if (slot.seq.load(std::memory_order_acquire) != ticket + 1) {
+        return false;
+    }
+    std::memcpy(&out, &slot.record, sizeof(out));
+    std::atomic_thread_fence(std::memory_order_acquire);
+    return slot.seq.load(std::memory_order_relaxed) == ticket + 1;
+}
+
+void write_all(int fd, const char* data, size_t n) {
+    while (n > 0) {
+        ssize_t written = ::write(fd, data, n);
+        if (written <= 0) {
+            return;
+        }
+        data += written;
+        n -= static_cast<size_t>(written);
+    }
+}
+
+} // namespace
+
+// 注意：静态成员保证多个动态库共享同一个崩溃处理对象
+std::atomic<FlightRecorder*> FlightRecorder::crash_recorder_{nullptr};
+
+FlightRecorder::FlightRecorder(const std::string& path, const std::string& dump_path, size_t records) {
+    const size_t slot_count = round_up_pow2(std::max<size_t>(records, 16));
+    mapping_size_ = sizeof(FlightFileHeader) + slot_count * sizeof(FlightSlot);
+
+    if (!path.empty()) {
+        // 保留上一次运行（可能是崩溃）的记录
+        if (::access(path.c_str(), F_OK) == 0) {
+            std::rename(path.c_str(), (path + ".prev").c_str());
+        }
+        int fd = ::open(path.c_str(), O_RDWR | O_CREAT | O_TRUNC, 0644);
+        if (fd >= 0) {
+            if (::ftruncate(fd, static_cast<off_t>(mapping_size_)) == 0) {
+                void* p = ::mmap(nullptr, mapping_size_, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+                if (p != MAP_FAILED) {
+                    mapping_ = p;
+                }
+            }
+            ::close(fd);
+        }
+    }
+    if (mapping_ == nullptr) {
+        void* p = ::mmap(nullptr, mapping_size_, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+        mapping_ = p != MAP_FAILED ? p : nullptr;
+    }
+
+    if (mapping_ != nullptr) {
+        // 预先触碰全部页面，避免热路径上的缺页中断
+        std::memset(mapping_, 0, mapping_size_);
+        header_ = static_cast<FlightFileHeader*>(mapping_);
+        std::memcpy(header_->magic, kFlightMagic, sizeof(kFlightMagic));
+        header_->slot_size = static_cast<uint32_t>(sizeof(FlightSlot));
+        header_->slot_count = slot_count;
+        slots_ = reinterpret_cast<FlightSlot*>(static_cast<char*>(mapping_) + sizeof(FlightFileHeader));
+        mask_ = slot_count - 1;
+    }
+
+    if (!dump_path.empty()) {
+        dump_fd_ = ::open(dump_path.c_str(), O_WRONLY | O_CREAT | O_APPEND, 0644);
+    }
+}
+
+FlightRecorder::~FlightRecorder() {
+    FlightRecorder* self = this;
+    crash_recorder_.compare_exchange_strong(self, nullptr);
+    if (mapping_ != nullptr) {
+        ::munmap(mapping_, mapping_size_);
+    }
+    if (dump_fd_ >= 0) {
+        ::close(dump_fd_);
+    }
+}
+
+void FlightRecorder::log(const spdlog::details::log_msg& msg) {
+    if (header_ == nullptr) {
+        return;
+    }
+    const uint64_t ticket = header_->next.fetch_add(1, std::memory_order_relaxed);
+    FlightSlot& slot = slots_[ticket & mask_];
+    // 环转满一圈追上了仍在写入的线程：放弃本条，避免两个写入者交错
+    if (slot.seq.exchange(kSlotBusy, std::memory_order_acquire) == kSlotBusy) {
+        dropped_.fetch_add(1, std::memory_order_relaxed);
+        return;
+    }
+
+    FlightRecord& rec = slot.record;
+    rec.time_ns = std::chrono::duration_cast<std::chrono::nanoseconds>(msg.time.time_since_epoch()).count();
+    rec.thread_id = msg.thread_id;
+    rec.level = static_cast<int32_t>(msg.level);
+    rec.line = msg.source.line;
+    copy_truncated(rec.logger, msg.logger_name.data(), msg.logger_name.size());
+    const char* file = basename_of(msg.source.filename);
+    copy_truncated(rec.file, file, std::strlen(file));
+    rec.text_len = static_cast<uint32_t>(std::min(msg.payload.size(), sizeof(rec.text)));
+    std::memcpy(rec.text, msg.payload.data(), rec.text_len);
+    slot.seq.store(ticket + 1, std::memory_order_release);
+
+    if (msg.level >= spdlog::level::err) {
+        dump();
+    }
+}
+
+size_t FlightRecorder::dump() {
+    std::lock_guard<std::mutex> lock(dump_mutex_);
+    return dump_to_fd(dump_fd_ >= 0 ? dump_fd_ : STDERR_FILENO, false);
+}
+
+size_t FlightRecorder::dump_to_fd(int fd, bool signal_safe) {
+    if (header_ == nullptr) {
+        return 0;
+    }
+    const uint64_t end = header_->next.load(std::memory_order_acquire);
+    const uint64_t oldest = end > capacity() ? end - capacity() : 0;
+    const uint64_t begin = std::max(oldest, dumped_.load(std::memory_order_relaxed));
+
+    size_t count = 0;
+    FlightRecord rec;
+    for (uint64_t ticket = begin; ticket < end; ++ticket) {
+        if (!read_slot(slots_[ticket & mask_], ticket, rec)) {
+            continue;
+        }
+        LineBuffer line;
+        format_record(rec, signal_safe, line);
+        write_all(fd, line.data, line.size);
+        ++count;
+    }
+    dumped_.store(end, std::memory_order_relaxed);
+    return count;
+}
+
+void FlightRecorder::install_crash_handler() {
+    FlightRecorder* expected = nullptr;
+    if (!crash_recorder_.compare_exchange_strong(expected, this)) {
+        return; // 只安装一次
+    }
+    struct sigaction action;
+    std::memset(&action, 0, sizeof(action));
+    action.sa_handler = &FlightRecorder::on_fatal_signal;
+    sigemptyset(&action.sa_mask);
+    for (size_t i = 0; i < kFatalSignalCount; ++i) {
+        ::sigaction(kFatalSignals[i], &action, &g_previous_actions[i]);
+    }
+}
+
+void FlightRecorder::on_fatal_signal(int sig) {
+    FlightRecorder* recorder = crash_recorder_.exchange(nullptr);
+    if (recorder != nullptr) {
+        recorder->dump_to_fd(recorder->dump_fd_ >= 0 ? recorder->dump_fd_ : STDERR_FILENO, true);
+        if (recorder->dump_fd_ >= 0) {
+            ::fsync(recorder->dump_fd_);
+        }
+    }
+    // 交还原处理函数并重新触发信号
+    for (size_t i = 0; i < kFatalSignalCount; ++i) {
+        if (kFatalSignals[i] == sig) {
+            ::sigaction(sig, &g_previous_actions[i], nullptr);
+        }
+    }
+    ::raise(sig);
+}
+
+long decode_flight_file(const std::string& path, FILE* out) {
+    FILE* file = std::fopen(path.c_str(), "rb");
+    if (file == nullptr) {
+        return -1;
+    }
+    std::vector<char> data;
+    char chunk[1 << 16];
+    size_t n;
+    while ((n = std::fread(chunk, 1, sizeof(chunk), file)) > 0) {
+        data.insert(data.end(), chunk, chunk + n);
+    }
+    std::fclose(file);
+
+    if (data.size() < sizeof(FlightFileHeader) || std::memcmp(data.data(), kFlightMagic, sizeof(kFlightMagic)) != 0) {
+        return -1;
+    }
+    const auto* header = reinterpret_cast<const FlightFileHeader*>(data.data());
+    const uint64_t slot_count = header->slot_count;
+    if (header->slot_size != sizeof(FlightSlot) || slot_count == 0 || (slot_count & (slot_count - 1)) != 0 ||
+        data.size() < sizeof(FlightFileHeader) + slot_count * sizeof(FlightSlot)) {
+        return -1;
+    }
+    const auto* slots = reinterpret_cast<const FlightSlot*>(data.data() + sizeof(FlightFileHeader));
+    const uint64_t end = header->next.load(std::memory_order_relaxed);
+    const uint64_t begin = end > slot_count ? end - slot_count : 0;
+
+    long count = 0;
+    FlightRecord rec;
+    for (uint64_t ticket = begin; ticket < end; ++ticket) {
+        if (!read_slot(slots[ticket & (slot_count - 1)], ticket, rec)) {
+            continue;
+        }
+        LineBuffer line;
+        format_record(rec, false, line);
+        std::fwrite(line.data, 1, line.size, out);
+        ++count;
+    }
+    return count;
+}
+
+} // namespace proj_logger
@@ -0,0 +1,103 @@
+// flight_recorder.h
+#ifndef PROJ_FLIGHT_RECORDER_H
+#define PROJ_FLIGHT_RECORDER_H
+
+#include <atomic>
+#include <cstdint>
+#include <cstdio>
+#include <mutex>
+#include <string>
+#include <spdlog/sinks/sink.h>
+
+// 飞行记录器：在预分配的mmap固定槽位环中保留最近N条日志（不受输出级别限制），
+// 调用线程只拷贝消息正文和元数据，不做模式格式化；
+// 按需、遇到ERROR或致命信号时把环中的新记录转储为文本。
+// 环映射到文件（MAP_SHARED），进程崩溃后内容仍保留在文件中，可用 proj_log_decode 离线解码
+namespace proj_logger {
+
+// 槽位大小固定，超长的消息正文被截断
+constexpr size_t kFlightSlotSize = 512;
+
+// 映射文件布局：[FlightFileHeader][FlightSlot x slot_count]
+struct FlightFileHeader {
+    char magic[8];                  // "PLOGFLT1"
+    uint32_t slot_size;
+    uint32_t reserved;
+    uint64_t slot_count;
+    std::atomic<uint64_t> next;     // 下一个写入序号
+    uint8_t padding[32];
+};
+
+// 一条记录（不含序号，可直接按值拷贝）
+struct FlightRecord {
+    int64_t time_ns;
+    uint64_t thread_id;
+    int32_t level;
+    int32_t line;
+    uint32_t text_len;
+    char logger[20];
+    char file[40];
+    char text[kFlightSlotSize - 96];
+};
+
+struct FlightSlot {
+    std::atomic<uint64_t> seq;      // 序号+1；0为空槽，全1表示正在写入
+    FlightRecord record;
+};
+
+static_assert(sizeof(FlightFileHeader) == 64, "flight file header must stay 64 bytes");
+static_assert(sizeof(FlightSlot) == kFlightSlotSize, "flight slot size mismatch");
+
+class FlightRecorder : public spdlog::sinks::sink {
+public:
+    // path：环的映射文件（已存在的旧文件重命名为 path.prev）；为空或映射失败时使用匿名内存
+    // dump_path：转储文本追加写入的文件，为空时写到stderr
+    // records：槽位数，向上取整为2的幂
+    FlightRecorder(const std::string& path, const std::string& dump_path, size_t records);
+    ~FlightRecorder() override;
+
+    FlightRecorder(const FlightRecorder&) = delete;
+    FlightRecorder& operator=(const FlightRecorder&) = delete;
+
+    // 写入槽位；级别达到ERROR时同步转储
+    void log(const spdlog::details::log_msg& msg) override;
+    // 映射内容由内核回写，flush不做任何事
+    void flush() override {}
+    // 转储使用固定格式，不需要pattern
+    void set_pattern(const std::string&) override {}
+    void set_formatter(std::unique_ptr<spdlog::formatter>) override {}
+
+    // 转储上次转储之后的新记录，返回转储的条数
+    size_t dump();
+
+    // 安装致命信号处理（SIGSEGV/SIGBUS/SIGFPE/SIGILL/SIGABRT），
+    // 信号到来时以异步信号安全的方式转储，然后交还原处理函数
+    void install_crash_handler();
+
+    size_t capacity() const { return mask_ + 1; }
+    uint64_t dropped() const { return dropped_.load(std::memory_order_relaxed); }
+
+private:
+    size_t dump_to_fd(int fd, bool signal_safe);
+    static void on_fatal_signal(int sig);
+
+    static std::atomic<FlightRecorder*> crash_recorder_;
+
+    void* mapping_ = nullptr;
+    size_t mapping_size_ = 0;
+    FlightFileHeader* header_ = nullptr;
+    FlightSlot* slots_ = nullptr;
+    size_t mask_ = 0;
+
+    int dump_fd_ = -1;
+    std::atomic<uint64_t> dumped_{0};   // 已转储到的序号
+    std::atomic<uint64_t> dropped_{0};  // 槽位被并发写入者占用而丢弃的条数
+    std::mutex dump_mutex_;
+};
+
+// 离线解码飞行记录文件，按写入顺序输出文本，返回解码的记录数，文件无效返回-1
+long decode_flight_file(const std::string& path, FILE* out);
+
+} // namespace proj_logger
+
+#endif // PROJ_FLIGHT_RECORDER_H
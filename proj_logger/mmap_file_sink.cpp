@@ -0,0 +1,173 @@
+#include "mmap_file_sink.h"
+#include <algorithm>
+#include <atomic>
+#include <cstring>
+#include <stdexcept>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <unistd.h>
+
+namespace proj_logger {
+
+// 一个映射的段文件；最后一个引用释放时解除映射并截断到实际长度
+struct MmapFileSink::Segment {
+    std::string path;
+    int fd = -1;
+    char* data = nullptr;
+    size_t capacity = 0;
+    std::atomic<size_t> used{0};
+    size_t synced = 0;  // 仅后台线程访问
+
+    ~Segment() {
+        if (data != nullptr) {
+            ::munmap(data, capacity);
+        }
+        if (fd >= 0) {
+            if (::ftruncate(fd, static_cast<off_t>(used.load(std::memory_order_relaxed))) != 0) {
+                // 截断失败时文件尾部保留未使用的零字节，不影响已写入内容
+            }
+            ::close(fd);
+        }
+    }
+};
+
+MmapFileSink::MmapFileSink(const MmapFileSinkConfig& config)
+    : config_(config) {
+    if (config_.segment_bytes == 0) {
+        throw std::invalid_argument("MmapFileSink: segment_bytes must be positive");
+    }
+    sync_thread_ = std::thread([this]() { sync_loop(); });
+}
+
+MmapFileSink::~MmapFileSink() {
+    {
+        std::lock_guard<std::mutex> lock(sync_mutex_);
+        stopping_ = true;
+    }
+    sync_cv_.notify_all();
+    if (sync_thread_.joinable()) {
+        sync_thread_.join();
+    }
+    std::lock_guard<std::mutex> lock(mutex_);
+    current_.reset();
+}
+
+std::string MmapFileSink::current_path() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return current_ ? current_->path : std::string();
+}
+
+void MmapFileSink::open_segment(spdlog::log_clock::time_point now) {
+    current_.reset();
+
+    auto segment = std::make_shared<Segment>();
+    // 跳过已存在的段文件，不覆盖之前运行的日志
+    size_t index = next_index_;
+    for (;; ++index) {
+        segment->path = config_.path + "." + std::to_string(index);
+        if (::access(segment->path.c_str(), F_OK) != 0) {
+            break;
+        }
+    }
+
+    // 创建失败：删除残留的段文件，序号不前进，退避到 retry_deadline_ 再重试
+    auto fail = [&]() {
+        if (segment->fd >= 0) {
+            ::close(segment->fd);
+            segment->fd = -1;
+            ::unlink(segment->path.c_str());
+        }
+        next_index_ = index;
+        retry_deadline_ = now + config_.retry_interval;
+    };
+
+    segment->fd = ::open(segment->path.c_str(), O_RDWR | O_CREAT | O_TRUNC, 0644);
+    if (segment->fd < 0) {
+        fail();
+        return;
+    }
+    // 预分配磁盘块：稀疏文件在磁盘满时写映射区会触发SIGBUS
+    if (::posix_fallocate(segment->fd, 0, static_cast<off_t>(config_.segment_bytes)) != 0) {
+        fail();
+        return;
+    }
+    void* p = ::mmap(nullptr, config_.segment_bytes, PROT_READ | PROT_WRITE, MAP_SHARED, segment->fd, 0);
+    if (p == MAP_FAILED) {
+        fail();
+        return;
+    }
+    segment->data = static_cast<char*>(p);
+    segment->capacity = config_.segment_bytes;
+    current_ = std::move(segment);
+    next_index_ = index + 1;
+
+    if (config_.rotate_interval.count() > 0) {
+        rotate_deadline_ = now + config_.rotate_interval;
+    }
+}
+
+void MmapFileSink::sink_it_(const spdlog::details::log_msg& msg) {
+    spdlog::memory_buf_t formatted;
+    formatter_->format(msg, formatted);
+
+    const bool time_due = config_.rotate_interval.count() > 0 && msg.time >= rotate_deadline_;
+    // 放不下时切换段；超过整段容量的记录在空段中直接截断写入，不为它切出空段
+    const size_t size = formatted.size();
+    const size_t used_before = current_ ? current_->used.load(std::memory_order_relaxed) : 0;
+    if (!current_ || time_due || (used_before > 0 && used_before + size > current_->capacity)) {
+        if (!current_ && msg.time < retry_deadline_) {
+            dropped_.fetch_add(1, std::memory_order_relaxed); // 上次创建失败，退避期内直接丢弃
+            return;
+        }
+        open_segment(msg.time);
+        if (!current_) {
+            dropped_.fetch_add(1, std::memory_order_relaxed);
+            return;
+        }
+    }
+
+    const size_t used = current_->used.load(std::memory_order_relaxed);
+    size_t n = size;
+    if (n > current_->capacity - used) {
+        // 单条记录超过段容量：截断到段尾并计数，末字节改为换行，后续记录仍从新行开始
+        n = current_->capacity - used;
+        truncated_.fetch_add(1, std::memory_order_relaxed);
+    }
+    std::memcpy(current_->data + used, formatted.data(), n);
+    if (n < size && n > 0) {
+        current_->data[used + n - 1] = '\n';
+    }
+    current_->used.store(used + n, std::memory_order_release);
+}
+
+void MmapFileSink::flush_() {
+    if (current_) {
+        ::msync(current_->data, current_->used.load(std::memory_order_relaxed), MS_ASYNC);
+    }
+}
+
+void MmapFileSink::sync_loop() {
+    const size_t page = static_cast<size_t>(::sysconf(_SC_PAGESIZE));
+    std::unique_lock<std::mutex> sync_lock(sync_mutex_);
+    while (!stopping_) {
+        sync_cv_.wait_for(sync_lock, config_.sync_interval);
+
+        std::shared_ptr<Segment> segment;
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            segment = current_;
+        }
+        if (!segment) {
+            continue;
+        }
+        // 同步落盘不持有写入锁，调用线程只在切换段时与后台线程竞争
+        const size_t used = segment->used.load(std::memory_order_acquire);
+        if (used > segment->synced) {
+            const size_t begin = segment->synced / page * page;
+            ::msync(segment->data + begin, used - begin, MS_SYNC);
+            segment->synced = used;
+        }
+    }
+}
+
+} // namespace proj_logger
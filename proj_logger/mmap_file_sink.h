@@ -0,0 +1,74 @@
+// mmap_file_sink.h
+#ifndef PROJ_MMAP_FILE_SINK_H
+#define PROJ_MMAP_FILE_SINK_H
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <spdlog/sinks/base_sink.h>
+
+namespace proj_logger {
+
+// mmap文件sink配置
+struct MmapFileSinkConfig {
+    std::string path;                                   // 段文件名前缀，实际文件为 path.0、path.1 ...
+    size_t segment_bytes = 64 * 1024 * 1024;            // 单个段文件预分配大小，写满后切换；超过它的单条记录被截断
+    std::chrono::seconds rotate_interval{0};            // 按时间切换段，0表示不按时间切换
+    std::chrono::milliseconds sync_interval{1000};      // 后台msync周期
+    std::chrono::milliseconds retry_interval{1000};     // 段文件创建失败后的重试间隔，期间的记录丢弃并计数
+};
+
+// mmap文件sink：段文件预分配并整体映射，每条日志格式化后直接拷贝进映射区（无系统调用），
+// 写满或到时间后切换到新段，后台线程周期性msync已写入的范围
+// 段关闭时截断到实际写入长度；超过段容量的单条记录截断写入并计数
+// 段文件创建失败（磁盘满等）时删除残留文件，按 retry_interval 退避重试，不逐条重试
+class MmapFileSink : public spdlog::sinks::base_sink<std::mutex> {
+public:
+    // segment_bytes 为0时抛出 std::invalid_argument
+    explicit MmapFileSink(const MmapFileSinkConfig& config);
+    ~MmapFileSink() override;
+
+    MmapFileSink(const MmapFileSink&) = delete;
+    MmapFileSink& operator=(const MmapFileSink&) = delete;
+
+    // 当前段文件路径（未打开时为空）
+    std::string current_path();
+
+    // 因超过段容量被截断的记录数
+    uint64_t truncated_count() const { return truncated_.load(std::memory_order_relaxed); }
+    // 因段文件创建失败被丢弃的记录数
+    uint64_t dropped_count() const { return dropped_.load(std::memory_order_relaxed); }
+
+protected:
+    void sink_it_(const spdlog::details::log_msg& msg) override;
+    // 映射区的数据对读者立即可见，flush只提交异步回写
+    void flush_() override;
+
+private:
+    struct Segment;
+
+    void open_segment(spdlog::log_clock::time_point now);
+    void sync_loop();
+
+    const MmapFileSinkConfig config_;
+    size_t next_index_ = 0;
+    std::shared_ptr<Segment> current_;  // 受基类 mutex_ 保护；后台线程持有引用期间段不会被unmap
+    spdlog::log_clock::time_point rotate_deadline_;
+    spdlog::log_clock::time_point retry_deadline_;  // 创建失败后在此之前不再重试
+    std::atomic<uint64_t> truncated_{0};
+    std::atomic<uint64_t> dropped_{0};
+
+    std::mutex sync_mutex_;
+    std::condition_variable sync_cv_;
+    bool stopping_ = false;
+    std::thread sync_thread_;
+};
+
+} // namespace proj_logger
+
+#endif // PROJ_MMAP_FILE_SINK_H
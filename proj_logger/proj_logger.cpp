@@ -6,17 +6,246 @@
 #include <vector>
 #include <cstdlib>
 #include <algorithm>
+#include <stdexcept>
 #include <iostream>
+#include <fstream>
+#include <iterator>
+#include <csignal>
+#include <signal.h>
+#include <sys/stat.h>
 
 namespace proj_logger {
 
+namespace {
+
+// 转发到共享输出sink，自身级别即模块的输出级别
+class ModuleOutputSink : public spdlog::sinks::sink {
+public:
+    explicit ModuleOutputSink(std::shared_ptr<spdlog::sinks::sink> inner) : inner_(std::move(inner)) {}
+    void log(const spdlog::details::log_msg& msg) override { inner_->log(msg); }
+    void flush() override { inner_->flush(); }
+    void set_pattern(const std::string& pattern) override { inner_->set_pattern(pattern); }
+    void set_formatter(std::unique_ptr<spdlog::formatter> sink_formatter) override {
+        inner_->set_formatter(std::move(sink_formatter));
+    }
+
+private:
+    std::shared_ptr<spdlog::sinks::sink> inner_;
+};
+
+} // namespace
+
 // 实现日志管理器构造函数
 LoggerManager::LoggerManager() {
-    shared_sink_ = std::make_shared<spdlog::sinks::stdout_color_sink_mt>();
-    // 自动从环境变量初始化日志级别（仅执行一次）
+    // 自动从环境变量初始化输出sink和日志级别（仅执行一次）
+    init_sink_from_env();
+    init_flight_from_env();
     init_level_from_env();
 }
 
+LoggerManager::~LoggerManager() {
+    watch_level_file("");
+    if (binary_backend_) {
+        binary_backend_->shutdown();
+    }
+    if (ring_sink_) {
+        ring_sink_->shutdown();
+    }
+    if (async_sink_) {
+        async_sink_->shutdown();
+    }
+}
+
+// 字符串转溢出策略（支持大小写不敏感）
+proj_logger::OverflowPolicy LoggerManager::str_to_overflow_policy(const std::string& policy_str) {
+    std::string lower_str = policy_str;
+    std::transform(lower_str.begin(), lower_str.end(), lower_str.begin(), ::tolower);
+
+    if (lower_str == "drop_newest") return proj_logger::OverflowPolicy::DROP_NEWEST;
+    if (lower_str == "drop_oldest") return proj_logger::OverflowPolicy::DROP_OLDEST;
+    return proj_logger::OverflowPolicy::BLOCK; // 默认阻塞，不丢日志
+}
+
+// 注意：静态变量放在外部链接的函数内，保证多个动态库共享同一份配置
+MmapFileSinkConfig& LoggerManager::file_sink_config() {
+    static MmapFileSinkConfig config;
+    return config;
+}
+
+void LoggerManager::set_file_sink_config(const MmapFileSinkConfig& config) {
+    if (config.segment_bytes == 0) {
+        throw std::invalid_argument("set_file_sink_config: segment_bytes must be positive");
+    }
+    file_sink_config() = config;
+}
+
+// 创建最终输出sink：默认stdout，配置了文件路径时写mmap段文件
+// PROJ_LOG_FILE=path              段文件前缀，实际文件为 path.0、path.1 ...
+// PROJ_LOG_FILE_SEGMENT=67108864  单个段文件字节数，写满后切换
+// PROJ_LOG_FILE_ROTATE_SEC=3600   按时间切换段（秒），0表示不按时间切换
+// PROJ_LOG_FILE_SYNC_MS=1000      后台msync周期（毫秒）
+std::shared_ptr<spdlog::sinks::sink> LoggerManager::make_output_sink() {
+    MmapFileSinkConfig config = file_sink_config();
+    const char* file_val = std::getenv("PROJ_LOG_FILE");
+    if (file_val != nullptr && *file_val != '\0') {
+        config.path = file_val;
+    }
+    if (config.path.empty()) {
+        return std::make_shared<spdlog::sinks::stdout_color_sink_mt>();
+    }
+
+    const char* segment_val = std::getenv("PROJ_LOG_FILE_SEGMENT");
+    if (segment_val != nullptr && std::atoll(segment_val) > 0) {
+        config.segment_bytes = static_cast<size_t>(std::atoll(segment_val));
+    }
+    const char* rotate_val = std::getenv("PROJ_LOG_FILE_ROTATE_SEC");
+    if (rotate_val != nullptr && *rotate_val != '\0') {
+        config.rotate_interval = std::chrono::seconds(std::max(0LL, std::atoll(rotate_val)));
+    }
+    const char* sync_val = std::getenv("PROJ_LOG_FILE_SYNC_MS");
+    if (sync_val != nullptr && std::atoll(sync_val) > 0) {
+        config.sync_interval = std::chrono::milliseconds(std::atoll(sync_val));
+    }
+    std::cout<<"!!! Env set mmap file log "<<config.path<<", segment "<<config.segment_bytes
+             <<", rotate "<<config.rotate_interval.count()<<"s"<<std::endl;
+    return std::make_shared<MmapFileSink>(config);
+}
+
+// 从环境变量初始化输出sink
+// PROJ_LOG_ASYNC=1            开启异步批量写出（共享有界MPSC队列）
+// PROJ_LOG_ASYNC=ring         开启异步写出（每线程SPSC环，后台按时间戳归并）
+// PROJ_LOG_ASYNC_QUEUE=8192   队列容量
+// PROJ_LOG_ASYNC_RING=262144  每线程环字节数（ring模式）
+// PROJ_LOG_ASYNC_POLICY=block 队列满策略：block/drop_newest/drop_oldest
+// 开启二进制模式（PROJ_LOG_BINARY/PROJ_LOG_BINARY_FILE）时忽略 PROJ_LOG_ASYNC
+// PROJ_LOG_FORMAT=json       每条日志输出一行JSON（结构化日志的字段并入该对象）
+void LoggerManager::init_sink_from_env() {
+    const char* format_val = std::getenv("PROJ_LOG_FORMAT");
+    if (format_val != nullptr && std::string(format_val) == "json") {
+        json_format_ = true;
+        std::cout<<"!!! Env set json log format"<<std::endl;
+    }
+
+    auto output_sink = make_output_sink();
+    shared_sink_ = output_sink;
+
+    init_binary_from_env();
+
+    const char* async_val = std::getenv("PROJ_LOG_ASYNC");
+    if (async_val == nullptr || *async_val == '\0' ||
+        std::string(async_val) == "0" || std::string(async_val) == "off") {
+        return;
+    }
+    if (binary_backend_) {
+        // 二进制模式与异步sink互斥：已由二进制后台线程写出，不再起第二个后台线程
+        std::cout<<"!!! Env async log ignored in binary log mode"<<std::endl;
+        return;
+    }
+
+    size_t queue_size = 8192;
+    const char* queue_val = std::getenv("PROJ_LOG_ASYNC_QUEUE");
+    if (queue_val != nullptr && std::atoll(queue_val) > 0) {
+        queue_size = static_cast<size_t>(std::atoll(queue_val));
+    }
+
+    proj_logger::OverflowPolicy policy = proj_logger::OverflowPolicy::BLOCK;
+    const char* policy_val = std::getenv("PROJ_LOG_ASYNC_POLICY");
+    if (policy_val != nullptr && *policy_val != '\0') {
+        policy = str_to_overflow_policy(policy_val);
+    }
+
+    if (std::string(async_val) == "ring") {
+        size_t ring_bytes = 256 * 1024;
+        const char* ring_val = std::getenv("PROJ_LOG_ASYNC_RING");
+        if (ring_val != nullptr && std::atoll(ring_val) > 0) {
+            ring_bytes = static_cast<size_t>(std::atoll(ring_val));
+        }
+        ring_sink_ = std::make_shared<ThreadRingSink>(output_sink, ring_bytes, policy);
+        shared_sink_ = ring_sink_;
+        std::cout<<"!!! Env set async ring log, ring bytes "<<ring_bytes
+                 <<", policy "<<cvtOverflowPolicy(policy).c_str()<<std::endl;
+        return;
+    }
+
+    async_sink_ = std::make_shared<AsyncSink>(output_sink, queue_size, policy);
+    shared_sink_ = async_sink_;
+    std::cout<<"!!! Env set async log, queue "<<queue_size
+             <<", policy "<<cvtOverflowPolicy(policy).c_str()<<std::endl;
+}
+
+// 从环境变量初始化二进制模式
+// PROJ_LOG_BINARY=1             调用点只记录原始参数，后台线程格式化后写入sink
+// PROJ_LOG_BINARY_FILE=path     后台线程写出二进制文件，用 proj_log_decode 离线解码
+// PROJ_LOG_BINARY_RING=1048576  每线程环字节数，环满时丢弃新记录
+void LoggerManager::init_binary_from_env() {
+    const char* file_val = std::getenv("PROJ_LOG_BINARY_FILE");
+    const char* binary_val = std::getenv("PROJ_LOG_BINARY");
+    const bool to_file = file_val != nullptr && *file_val != '\0';
+    const bool to_sink = binary_val != nullptr && *binary_val != '\0' &&
+                         std::string(binary_val) != "0" && std::string(binary_val) != "off";
+    if (!to_file && !to_sink) {
+        return;
+    }
+    // 二进制模式由后台线程写出，与异步sink互斥（init_sink_from_env 随后不再创建）；下游直接取输出sink
+    binary_backend_ = std::make_unique<BinaryLogBackend>(shared_sink_, to_file ? file_val : "");
+    std::cout<<"!!! Env set binary log"<<(to_file ? ", file " : "")<<(to_file ? file_val : "")<<std::endl;
+}
+
+// 从环境变量初始化飞行记录器
+// PROJ_LOG_FLIGHT_FILE=path      开启，最近的记录保存在mmap映射的path中（崩溃后可用 proj_log_decode 解码）
+// PROJ_LOG_FLIGHT_DUMP=path      转储文本追加写入的文件，默认 <PROJ_LOG_FLIGHT_FILE>.log
+// PROJ_LOG_FLIGHT_RECORDS=4096   保留的记录条数
+// PROJ_LOG_FLIGHT_LEVEL=debug    记录级别，低于输出级别的日志也会进入记录器
+void LoggerManager::init_flight_from_env() {
+    const char* file_val = std::getenv("PROJ_LOG_FLIGHT_FILE");
+    if (file_val == nullptr || *file_val == '\0') {
+        return;
+    }
+    if (binary_backend_) {
+        // 二进制模式的调用点不经过sink，无法同时记录
+        std::cout<<"!!! Env flight recorder ignored in binary log mode"<<std::endl;
+        return;
+    }
+
+    std::string dump_path = std::string(file_val) + ".log";
+    const char* dump_val = std::getenv("PROJ_LOG_FLIGHT_DUMP");
+    if (dump_val != nullptr && *dump_val != '\0') {
+        dump_path = dump_val;
+    }
+    size_t records = 4096;
+    const char* records_val = std::getenv("PROJ_LOG_FLIGHT_RECORDS");
+    if (records_val != nullptr && std::atoll(records_val) > 0) {
+        records = static_cast<size_t>(std::atoll(records_val));
+    }
+    const char* level_val = std::getenv("PROJ_LOG_FLIGHT_LEVEL");
+    if (level_val != nullptr && *level_val != '\0') {
+        flight_level_ = to_spdlog_level(str_to_loglevel(level_val));
+    }
+
+    flight_recorder_ = std::make_shared<FlightRecorder>(file_val, dump_path, records);
+    flight_recorder_->set_level(flight_level_);
+    flight_recorder_->install_crash_handler();
+    std::cout<<"!!! Env set flight recorder "<<file_val<<", records "<<flight_recorder_->capacity()
+             <<", dump to "<<dump_path<<std::endl;
+}
+
+size_t LoggerManager::dump_flight_recorder() {
+    return flight_recorder_ ? flight_recorder_->dump() : 0;
+}
+
+void LoggerManager::flush_binary() {
+    if (binary_backend_) {
+        binary_backend_->flush();
+    }
+}
+
+AsyncSinkStats LoggerManager::async_stats() const {
+    if (ring_sink_) {
+        return ring_sink_->stats();
+    }
+    return async_sink_ ? async_sink_->stats() : AsyncSinkStats{};
+}
+
 // 字符串转日志级别（支持大小写不敏感）
 proj_logger::LogLevel LoggerManager::str_to_loglevel(const std::string& level_str) {
     std::string lower_str = level_str;
@@ -32,22 +261,181 @@ proj_logger::LogLevel LoggerManager::str_to_loglevel(const std::string& level_st
     return proj_logger::LogLevel::INFO; // 默认级别
 }
 
-// 从环境变量初始化日志级别（仅执行一次）
-void LoggerManager::init_level_from_env() {
-    static bool has_checked = false; // 保证只读取一次环境变量
-    if (has_checked) return;
+// 解析级别配置："warn" 或 "info,PROJ=warn,hand=debug"（不带模块名的项为默认级别）
+void LoggerManager::parse_level_spec(const std::string& spec, spdlog::level::level_enum& default_level,
+                                     std::unordered_map<std::string, spdlog::level::level_enum>& module_levels) {
+    size_t pos = 0;
+    while (pos <= spec.size()) {
+        size_t comma = spec.find_first_of(",;\n", pos);
+        if (comma == std::string::npos) comma = spec.size();
+        std::string item = spec.substr(pos, comma - pos);
+        pos = comma + 1;
+
+        item.erase(std::remove_if(item.begin(), item.end(), ::isspace), item.end());
+        if (item.empty() || item[0] == '#') {
+            continue;
+        }
+        size_t eq = item.find('=');
+        if (eq == std::string::npos) {
+            default_level = to_spdlog_level(str_to_loglevel(item));
+        } else if (eq > 0) {
+            module_levels[item.substr(0, eq)] = to_spdlog_level(str_to_loglevel(item.substr(eq + 1)));
+        }
+    }
+}
 
+// 从环境变量初始化日志级别，可重复调用（级别文件变化时重新加载）
+// PROJ_LOG_LEVEL=info,PROJ=warn,hand=debug  默认级别与按模块（日志器名）的级别
+// PROJ_LOG_LEVEL_FILE=path                   级别配置文件（格式同上），修改文件或发送SIGHUP时重新加载
+void LoggerManager::init_level_from_env() {
+    std::string spec;
     const char* env_val = std::getenv("PROJ_LOG_LEVEL");
     if (env_val != nullptr && *env_val != '\0') {
-        proj_logger::LogLevel level = str_to_loglevel(env_val);
-        default_level_ = to_spdlog_level(level);
-        std::cout<<"!!! Env set log_level to "<<cvtLogLevel(level).c_str()<<std::endl;
+        spec = env_val;
+        std::cout<<"!!! Env set log_level to "<<spec<<std::endl;
+    }
+    const char* file_val = std::getenv("PROJ_LOG_LEVEL_FILE");
+    if (file_val != nullptr && *file_val != '\0' && level_file_.empty()) {
+        watch_level_file(file_val);
+        return; // 监视线程启动时已加载一次
+    }
+    set_log_levels(spec);
+}
+
+// 按配置设置级别：未出现的模块恢复为默认级别
+void LoggerManager::set_log_levels(const std::string& spec) {
+    spdlog::level::level_enum level = spdlog::level::info;
+    std::unordered_map<std::string, spdlog::level::level_enum> module_levels;
+    parse_level_spec(spec, level, module_levels);
+
+    std::lock_guard<std::mutex> lock(mtx_);
+    default_level_ = level;
+    module_levels_ = std::move(module_levels);
+    for (auto& [name, logger] : loggers_) {
+        apply_level(*logger, output_level(name));
     }
+}
+
+void LoggerManager::set_module_log_level(const std::string& name, spdlog::level::level_enum level) {
+    std::lock_guard<std::mutex> lock(mtx_);
+    module_levels_[name] = level;
+    auto it = loggers_.find(name);
+    if (it != loggers_.end()) {
+        apply_level(*it->second, level);
+    }
+}
 
-    set_all_log_level(default_level_);
-    has_checked = true;
+spdlog::level::level_enum LoggerManager::module_log_level(const std::string& name) {
+    std::lock_guard<std::mutex> lock(mtx_);
+    return output_level(name);
 }
 
+// 注意：状态放在外部链接的函数内，保证多个动态库共享同一个标志（信号处理函数只写该标志）
+std::atomic<bool>& LoggerManager::level_reload_requested() {
+    static std::atomic<bool> requested{false};
+    return requested;
+}
+
+namespace {
+
+// 安装前的SIGHUP处理方式：收到信号时先请求重新加载，再链式调用宿主程序原有的处理函数
+struct sigaction& previous_sighup_action() {
+    static struct sigaction action{};
+    return action;
+}
+
+void on_level_reload_signal(int signo, siginfo_t* info, void* context) {
+    LoggerManager::request_level_reload();
+    const struct sigaction& previous = previous_sighup_action();
+    if ((previous.sa_flags & SA_SIGINFO) != 0) {
+        if (previous.sa_sigaction != nullptr) {
+            previous.sa_sigaction(signo, info, context);
+        }
+    } else if (previous.sa_handler != SIG_DFL && previous.sa_handler != SIG_IGN) {
+        // SIG_DFL 会终止进程，监视期间 SIGHUP 的含义就是重新加载，不再转发
+        previous.sa_handler(signo);
+    }
+}
+
+} // namespace
+
+void LoggerManager::install_sighup_handler() {
+    if (sighup_installed_) {
+        return;
+    }
+    struct sigaction action{};
+    action.sa_sigaction = on_level_reload_signal;
+    action.sa_flags = SA_SIGINFO | SA_RESTART;
+    sigemptyset(&action.sa_mask);
+    sighup_installed_ = ::sigaction(SIGHUP, &action, &previous_sighup_action()) == 0;
+}
+
+// 停止监视时恢复宿主程序原有的SIGHUP处理方式
+void LoggerManager::restore_sighup_handler() {
+    if (!sighup_installed_) {
+        return;
+    }
+    ::sigaction(SIGHUP, &previous_sighup_action(), nullptr);
+    sighup_installed_ = false;
+}
+
+void LoggerManager::request_level_reload() {
+    level_reload_requested().store(true, std::memory_order_relaxed);
+}
+
+// 监视级别文件：轮询文件修改时间，或由SIGHUP/request_level_reload触发立即重新加载
+// 重新加载只在监视线程中进行，调用线程读级别始终是一次relaxed原子读，不会被阻塞
+void LoggerManager::watch_level_file(const std::string& path) {
+    if (level_watcher_.joinable()) {
+        {
+            std::lock_guard<std::mutex> lock(watch_mutex_);
+            watch_stopping_ = true;
+        }
+        watch_cv_.notify_all();
+        level_watcher_.join();
+    }
+    level_file_ = path;
+    if (path.empty()) {
+        restore_sighup_handler();
+        return;
+    }
+
+    reload_level_file();
+    install_sighup_handler();
+    watch_stopping_ = false;
+    level_watcher_ = std::thread([this]() {
+        struct stat last{};
+        ::stat(level_file_.c_str(), &last);
+        std::unique_lock<std::mutex> lock(watch_mutex_);
+        while (!watch_cv_.wait_for(lock, std::chrono::milliseconds(200), [this]() { return watch_stopping_; })) {
+            struct stat now{};
+            const bool exists = ::stat(level_file_.c_str(), &now) == 0;
+            const bool changed = exists && (now.st_mtim.tv_sec != last.st_mtim.tv_sec ||
+                                            now.st_mtim.tv_nsec != last.st_mtim.tv_nsec ||
+                                            now.st_size != last.st_size);
+            if (changed || level_reload_requested().exchange(false, std::memory_order_relaxed)) {
+                last = now;
+                reload_level_file();
+            }
+        }
+    });
+}
+
+// 级别 = PROJ_LOG_LEVEL 叠加级别文件内容（文件中的项优先）
+void LoggerManager::reload_level_file() {
+    std::string spec;
+    const char* env_val = std::getenv("PROJ_LOG_LEVEL");
+    if (env_val != nullptr) {
+        spec = env_val;
+    }
+    std::ifstream in(level_file_);
+    if (in) {
+        std::string content((std::istreambuf_iterator<char>(in)), std::istreambuf_iterator<char>());
+        spec += "," + content;
+        std::cout<<"!!! Reload log_level from "<<level_file_<<std::endl;
+    }
+    set_log_levels(spec);
+}
 
 // 实现获取日志器
 std::shared_ptr<spdlog::logger> LoggerManager::get_logger(const std::string& name) {
@@ -57,19 +445,49 @@ std::shared_ptr<spdlog::logger> LoggerManager::get_logger(const std::string& nam
         return it->second;
     }
 
-    auto logger = std::make_shared<spdlog::logger>(name, shared_sink_);
-    logger->set_level(default_level_);
-    logger->set_pattern("[%Y-%m-%d %H:%M:%S.%e] [%n] [%l] [%s:%#] %v");
+    // 飞行记录器开启时，每个日志器的输出经过各自的级别过滤sink（输出级别按模块设置）
+    auto logger = flight_recorder_
+        ? std::make_shared<spdlog::logger>(name, spdlog::sinks_init_list{
+              std::make_shared<ModuleOutputSink>(shared_sink_), flight_recorder_})
+        : std::make_shared<spdlog::logger>(name, shared_sink_);
+    apply_level(*logger, output_level(name));
+    if (json_format_) {
+        logger->set_formatter(std::make_unique<JsonLineFormatter>());
+    } else {
+        logger->set_pattern("[%Y-%m-%d %H:%M:%S.%e] [%n] [%l] [%s:%#] %v");
+    }
     loggers_[name] = logger;
     return logger;
 }
 
-// 实现设置全局级别
+// 实现获取日志器句柄（返回的指针由loggers_持有，不会失效）
+spdlog::logger* LoggerManager::get_logger_handle(const std::string& name) {
+    return get_logger(name).get();
+}
+
+// 实现设置全局级别（同时清除按模块设置的级别）
 void LoggerManager::set_all_log_level(spdlog::level::level_enum level) {
     std::lock_guard<std::mutex> lock(mtx_);
     default_level_ = level;
+    module_levels_.clear();
     for (auto& [name, logger] : loggers_) {
-        logger->set_level(level);
+        apply_level(*logger, level);
+    }
+}
+
+// 模块输出级别（调用方持有mtx_）
+spdlog::level::level_enum LoggerManager::output_level(const std::string& name) const {
+    auto it = module_levels_.find(name);
+    return it != module_levels_.end() ? it->second : default_level_;
+}
+
+// 日志器级别为输出级别与飞行记录级别中较低者，输出级别由第一个sink过滤
+void LoggerManager::apply_level(spdlog::logger& logger, spdlog::level::level_enum level) {
+    if (flight_recorder_) {
+        logger.sinks().front()->set_level(level);
+        logger.set_level(std::min(level, flight_level_));
+    } else {
+        logger.set_level(level);
     }
 }
 
@@ -78,4 +496,8 @@ void set_global_log_level(proj_logger::LogLevel level) {
     LoggerManager::get_instance().set_all_log_level(to_spdlog_level(level));
 }
 
+size_t dump_flight_recorder() {
+    return LoggerManager::get_instance().dump_flight_recorder();
+}
+
 } // namespace proj_logger
\ No newline at end of file
@@ -6,7 +6,19 @@
 #include <spdlog/spdlog.h>
 #include <spdlog/common.h>  // 包含 source_loc 定义
 #include <memory>
+#include <atomic>
+#include <condition_variable>
+#include <mutex>
+#include <thread>
+#include <unordered_map>
 #include "enum_base.h"  // 引入新的枚举基础头文件
+#include "async_sink.h"
+#include "thread_ring_sink.h"
+#include "binary_log.h"
+#include "flight_recorder.h"
+#include "mmap_file_sink.h"
+#include "rate_limit.h"
+#include "structured_log.h"
 
 // 日志级别枚举
 namespace proj_logger {
@@ -34,26 +46,84 @@ public:
     // 获取日志器（在头文件中声明，确保编译器可见）
     std::shared_ptr<spdlog::logger> get_logger(const std::string& name);
 
-    // 设置所有日志器级别
+    // 获取日志器裸指针，供宏调用点缓存（日志器创建后永不删除，指针在管理器生命周期内有效）
+    spdlog::logger* get_logger_handle(const std::string& name);
+
+    // 设置所有日志器级别（清除按模块设置的级别）
     void set_all_log_level(spdlog::level::level_enum level);
     void init_level_from_env();
     proj_logger::LogLevel str_to_loglevel(const std::string& level_str);
 
+    // 按模块设置级别，spec 形如 "info,PROJ=warn,hand=debug"，未列出的模块使用默认级别
+    // 只修改各日志器的原子级别，调用线程的级别判断不加锁
+    void set_log_levels(const std::string& spec);
+    void set_module_log_level(const std::string& name, spdlog::level::level_enum level);
+    spdlog::level::level_enum module_log_level(const std::string& name);
+
+    // 监视级别配置文件，文件变化或收到SIGHUP时重新加载；path为空停止监视
+    // 监视期间SIGHUP处理函数会链式调用宿主程序原有的处理函数，停止监视时恢复原处理方式
+    void watch_level_file(const std::string& path);
+    // 请求监视线程立即重新加载（异步信号安全）
+    static void request_level_reload();
+
+    // 配置mmap文件输出（须在首次使用日志器之前调用，环境变量 PROJ_LOG_FILE* 优先）；segment_bytes 为0时抛出 std::invalid_argument
+    static void set_file_sink_config(const MmapFileSinkConfig& config);
+
+    // 从环境变量初始化输出sink（PROJ_LOG_FILE 写mmap文件，PROJ_LOG_ASYNC 开启异步批量写出）
+    void init_sink_from_env();
+    proj_logger::OverflowPolicy str_to_overflow_policy(const std::string& policy_str);
+    void init_binary_from_env();
+    void init_flight_from_env();
+
+    // 异步模式统计（同步模式下全为0）
+    AsyncSinkStats async_stats() const;
+
+    // 二进制模式：同步排空各线程环中已提交的记录
+    void flush_binary();
+
+    // 飞行记录器：转储上次转储之后的记录，未开启时返回0
+    size_t dump_flight_recorder();
+    bool flight_recorder_enabled() const { return flight_recorder_ != nullptr; }
+
     LoggerManager(const LoggerManager&) = delete;
     LoggerManager& operator=(const LoggerManager&) = delete;
 
 private:
     LoggerManager();  // 构造函数在cpp中实现
-    ~LoggerManager() = default;
+    static MmapFileSinkConfig& file_sink_config();
+    std::shared_ptr<spdlog::sinks::sink> make_output_sink();
+    void parse_level_spec(const std::string& spec, spdlog::level::level_enum& default_level,
+                          std::unordered_map<std::string, spdlog::level::level_enum>& module_levels);
+    spdlog::level::level_enum output_level(const std::string& name) const;
+    void apply_level(spdlog::logger& logger, spdlog::level::level_enum level);
+    void reload_level_file();
+    static std::atomic<bool>& level_reload_requested();
+    void install_sighup_handler();
+    void restore_sighup_handler();
+    ~LoggerManager(); // 异步模式下排空队列后退出
 
     std::shared_ptr<spdlog::sinks::sink> shared_sink_;
+    std::shared_ptr<AsyncSink> async_sink_; // 非空表示异步模式（MPSC队列）
+    std::shared_ptr<ThreadRingSink> ring_sink_; // 非空表示异步模式（每线程环）
+    std::unique_ptr<BinaryLogBackend> binary_backend_; // 非空表示二进制模式
+    std::shared_ptr<FlightRecorder> flight_recorder_; // 非空表示飞行记录器开启
+    spdlog::level::level_enum flight_level_ = spdlog::level::debug; // 飞行记录器记录级别
     std::unordered_map<std::string, std::shared_ptr<spdlog::logger>> loggers_;
     std::mutex mtx_;
     spdlog::level::level_enum default_level_ = spdlog::level::info; // 默认日志级别
+    std::unordered_map<std::string, spdlog::level::level_enum> module_levels_; // 按模块设置的级别
+    bool json_format_ = false;       // PROJ_LOG_FORMAT=json：输出JSON行
+
+    std::string level_file_;         // 监视的级别配置文件
+    std::thread level_watcher_;
+    std::mutex watch_mutex_;
+    std::condition_variable watch_cv_;
+    bool watch_stopping_ = false;
+    bool sighup_installed_ = false;  // 已安装SIGHUP处理函数（原处理方式待恢复）
 };
 
-// 转换日志级别
-inline spdlog::level::level_enum to_spdlog_level(proj_logger::LogLevel level) {
+// 转换日志级别（constexpr：宏中的级别判断可在编译期折叠）
+constexpr spdlog::level::level_enum to_spdlog_level(proj_logger::LogLevel level) {
     switch (level) {
         case proj_logger::LogLevel::TRACE: return spdlog::level::trace;
         case proj_logger::LogLevel::DEBUG: return spdlog::level::debug;
@@ -66,7 +136,7 @@ inline spdlog::level::level_enum to_spdlog_level(proj_logger::LogLevel level) {
     }
 }
 
-// 模板日志函数（头文件实现）
+// 模板日志函数（头文件实现）：按名称查找日志器，每次调用都会加锁查表
 template<typename... Args>
 void log(proj_logger::LogLevel level, const std::string& logger_name,
     const char* file, int line, const char* fmt, const Args&... args) {
@@ -75,16 +145,159 @@ void log(proj_logger::LogLevel level, const std::string& logger_name,
     logger->log(loc, to_spdlog_level(level), fmt, args...);
 }
 
+// 模板日志函数（缓存句柄版）：无锁、无分配、无引用计数，宏调用点使用
+template<typename... Args>
+void log(spdlog::logger* logger, proj_logger::LogLevel level,
+    const char* file, int line, const char* fmt, const Args&... args) {
+    spdlog::source_loc loc(file, line, __func__);
+    logger->log(loc, to_spdlog_level(level), fmt, args...);
+}
+
+// 结构化日志函数：字段编码为JSON对象后作为正文直接写出（不再经过fmt格式化）
+// 函数名位置填结构化标记，格式化器据此识别结构化正文
+template<typename... Ts>
+void slog(spdlog::logger* logger, proj_logger::LogLevel level,
+    const char* file, int line, std::string_view event, const LogField<Ts>&... fields) {
+    std::string_view payload = encode_structured(event, fields...);
+    spdlog::source_loc loc(file, line, kStructuredFuncname);
+    logger->log(loc, to_spdlog_level(level), spdlog::string_view_t(payload.data(), payload.size()));
+}
+
 void set_global_log_level(proj_logger::LogLevel level);
 
-// 宏定义
+// 按需转储飞行记录器（PROJ_LOG_FLIGHT_FILE 开启），返回转储的条数
+size_t dump_flight_recorder();
+
+// 编译期日志级别（数值与LogLevel一致），供预处理器比较
+#define PROJ_LOG_LEVEL_TRACE 0
+#define PROJ_LOG_LEVEL_DEBUG 1
+#define PROJ_LOG_LEVEL_INFO 2
+#define PROJ_LOG_LEVEL_WARN 3
+#define PROJ_LOG_LEVEL_ERROR 4
+#define PROJ_LOG_LEVEL_CRITICAL 5
+#define PROJ_LOG_LEVEL_OFF 6
+
+// 低于该级别的调用点在编译期被完全移除（参数不求值、不生成代码），默认全部保留
+#ifndef PROJ_LOG_ACTIVE_LEVEL
+#define PROJ_LOG_ACTIVE_LEVEL PROJ_LOG_LEVEL_TRACE
+#endif
+
+// 写出一条日志：二进制模式下只记录调用点ID和原始参数，格式化延迟到后台线程
+#define LOGGER_EMIT_(HANDLE, LEVEL, FMT, LOGGER_NAME, ...) \
+    do { \
+        if (proj_logger::binary_log_enabled()) { \
+            static const uint32_t proj_logger_site_ = proj_logger::register_log_site( \
+                LOGGER_NAME, proj_logger::LogLevel::LEVEL, __FILE__, __LINE__, FMT); \
+            proj_logger::binary_log(proj_logger_site_, ##__VA_ARGS__); \
+        } else { \
+            proj_logger::log(HANDLE, proj_logger::LogLevel::LEVEL, \
+                             __FILE__, __LINE__, FMT, ##__VA_ARGS__); \
+        } \
+    } while (0)
+
+// 宏定义：每个调用点用函数内静态变量缓存日志器句柄，仅首次调用时查表
+// 先读取日志器的原子级别，级别不满足时跳过参数求值和格式化
 #define LOGGER(LEVEL, FMT, LOGGER_NAME, ...) \
-    proj_logger::log(proj_logger::LogLevel::LEVEL, LOGGER_NAME, __FILE__, __LINE__, FMT, ##__VA_ARGS__)
+    do { \
+        static spdlog::logger* const proj_logger_handle_ = \
+            proj_logger::LoggerManager::get_instance().get_logger_handle(LOGGER_NAME); \
+        if (proj_logger_handle_->should_log( \
+                proj_logger::to_spdlog_level(proj_logger::LogLevel::LEVEL))) { \
+            LOGGER_EMIT_(proj_logger_handle_, LEVEL, FMT, LOGGER_NAME, ##__VA_ARGS__); \
+        } \
+    } while (0)
+
+// 限流宏：级别满足后再由调用点的限流器（LogEveryN/LogEveryMs）决定是否输出，
+// 有被抑制的重复时在消息末尾追加抑制次数（FMT须为字符串字面量）
+#define LOGGER_LIMITED(LEVEL, LIMITER, LIMIT, FMT, LOGGER_NAME, ...) \
+    do { \
+        static spdlog::logger* const proj_logger_handle_ = \
+            proj_logger::LoggerManager::get_instance().get_logger_handle(LOGGER_NAME); \
+        static proj_logger::LIMITER proj_logger_limiter_; \
+        uint64_t proj_logger_suppressed_ = 0; \
+        if (proj_logger_handle_->should_log( \
+                proj_logger::to_spdlog_level(proj_logger::LogLevel::LEVEL)) && \
+            proj_logger_limiter_.should_log(LIMIT, proj_logger_suppressed_)) { \
+            if (proj_logger_suppressed_ == 0) { \
+                LOGGER_EMIT_(proj_logger_handle_, LEVEL, FMT, LOGGER_NAME, ##__VA_ARGS__); \
+            } else { \
+                LOGGER_EMIT_(proj_logger_handle_, LEVEL, FMT " (suppressed {} repeats)", LOGGER_NAME, \
+                             ##__VA_ARGS__, proj_logger_suppressed_); \
+            } \
+        } \
+    } while (0)
+
+// 结构化日志宏：EVENT为事件名，其余参数为 proj_logger::kv("key", value) 字段
+// 二进制模式下JSON正文作为单个字符串参数记录
+#define LOGGER_KV(LEVEL, EVENT, LOGGER_NAME, ...) \
+    do { \
+        static spdlog::logger* const proj_logger_handle_ = \
+            proj_logger::LoggerManager::get_instance().get_logger_handle(LOGGER_NAME); \
+        if (proj_logger_handle_->should_log( \
+                proj_logger::to_spdlog_level(proj_logger::LogLevel::LEVEL))) { \
+            if (proj_logger::binary_log_enabled()) { \
+                static const uint32_t proj_logger_site_ = proj_logger::register_log_site( \
+                    LOGGER_NAME, proj_logger::LogLevel::LEVEL, __FILE__, __LINE__, "{}", true); \
+                proj_logger::binary_log(proj_logger_site_, proj_logger::encode_structured(EVENT, ##__VA_ARGS__)); \
+            } else { \
+                proj_logger::slog(proj_logger_handle_, proj_logger::LogLevel::LEVEL, \
+                                  __FILE__, __LINE__, EVENT, ##__VA_ARGS__); \
+            } \
+        } \
+    } while (0)
 
+// 编译期移除的调用点
+#define LOGGER_DISABLED() do {} while (0)
+
+#if PROJ_LOG_ACTIVE_LEVEL <= PROJ_LOG_LEVEL_TRACE
+#define MALOG_TRAC(module, fmt, ...) LOGGER(TRACE, fmt, module, ##__VA_ARGS__)
+#else
+#define MALOG_TRAC(module, fmt, ...) LOGGER_DISABLED()
+#endif
+
+#if PROJ_LOG_ACTIVE_LEVEL <= PROJ_LOG_LEVEL_DEBUG
 #define MALOG_DEBG(module, fmt, ...) LOGGER(DEBUG, fmt, module, ##__VA_ARGS__)
-#define MALOG_WARN(module, fmt, ...) LOGGER(WARN, fmt, module, ##__VA_ARGS__)
+#define MALOG_DEBG_KV(module, event, ...) LOGGER_KV(DEBUG, event, module, ##__VA_ARGS__)
+#else
+#define MALOG_DEBG(module, fmt, ...) LOGGER_DISABLED()
+#define MALOG_DEBG_KV(module, event, ...) LOGGER_DISABLED()
+#endif
+
+#if PROJ_LOG_ACTIVE_LEVEL <= PROJ_LOG_LEVEL_INFO
 #define MALOG_INFO(module, fmt, ...) LOGGER(INFO, fmt, module, ##__VA_ARGS__)
+#define MALOG_INFO_KV(module, event, ...) LOGGER_KV(INFO, event, module, ##__VA_ARGS__)
+#define MALOG_INFO_EVERY_N(module, n, fmt, ...) LOGGER_LIMITED(INFO, LogEveryN, n, fmt, module, ##__VA_ARGS__)
+#define MALOG_INFO_EVERY_MS(module, ms, fmt, ...) LOGGER_LIMITED(INFO, LogEveryMs, ms, fmt, module, ##__VA_ARGS__)
+#else
+#define MALOG_INFO(module, fmt, ...) LOGGER_DISABLED()
+#define MALOG_INFO_KV(module, event, ...) LOGGER_DISABLED()
+#define MALOG_INFO_EVERY_N(module, n, fmt, ...) LOGGER_DISABLED()
+#define MALOG_INFO_EVERY_MS(module, ms, fmt, ...) LOGGER_DISABLED()
+#endif
+
+#if PROJ_LOG_ACTIVE_LEVEL <= PROJ_LOG_LEVEL_WARN
+#define MALOG_WARN(module, fmt, ...) LOGGER(WARN, fmt, module, ##__VA_ARGS__)
+#define MALOG_WARN_KV(module, event, ...) LOGGER_KV(WARN, event, module, ##__VA_ARGS__)
+#define MALOG_WARN_EVERY_N(module, n, fmt, ...) LOGGER_LIMITED(WARN, LogEveryN, n, fmt, module, ##__VA_ARGS__)
+#define MALOG_WARN_EVERY_MS(module, ms, fmt, ...) LOGGER_LIMITED(WARN, LogEveryMs, ms, fmt, module, ##__VA_ARGS__)
+#else
+#define MALOG_WARN(module, fmt, ...) LOGGER_DISABLED()
+#define MALOG_WARN_KV(module, event, ...) LOGGER_DISABLED()
+#define MALOG_WARN_EVERY_N(module, n, fmt, ...) LOGGER_DISABLED()
+#define MALOG_WARN_EVERY_MS(module, ms, fmt, ...) LOGGER_DISABLED()
+#endif
+
+#if PROJ_LOG_ACTIVE_LEVEL <= PROJ_LOG_LEVEL_ERROR
 #define MALOG_ERRO(module, fmt, ...) LOGGER(ERROR, fmt, module, ##__VA_ARGS__)
+#define MALOG_ERRO_KV(module, event, ...) LOGGER_KV(ERROR, event, module, ##__VA_ARGS__)
+#define MALOG_ERRO_EVERY_N(module, n, fmt, ...) LOGGER_LIMITED(ERROR, LogEveryN, n, fmt, module, ##__VA_ARGS__)
+#define MALOG_ERRO_EVERY_MS(module, ms, fmt, ...) LOGGER_LIMITED(ERROR, LogEveryMs, ms, fmt, module, ##__VA_ARGS__)
+#else
+#define MALOG_ERRO(module, fmt, ...) LOGGER_DISABLED()
+#define MALOG_ERRO_KV(module, event, ...) LOGGER_DISABLED()
+#define MALOG_ERRO_EVERY_N(module, n, fmt, ...) LOGGER_DISABLED()
+#define MALOG_ERRO_EVERY_MS(module, ms, fmt, ...) LOGGER_DISABLED()
+#endif
 } // namespace proj_logger
 
 #endif // PROJ_LOGGER_H
\ No newline at end of file
@@ -0,0 +1,57 @@
+// rate_limit.h
+#ifndef PROJ_RATE_LIMIT_H
+#define PROJ_RATE_LIMIT_H
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+
+// 调用点级日志限流：每个调用点一个函数内静态对象，状态只用原子变量维护（无锁）
+// suppressed 返回自上次输出以来被抑制的次数，用于输出"suppressed N repeats"摘要
+namespace proj_logger {
+
+// 每N次输出一次（第1、N+1、2N+1...次）
+class LogEveryN {
+public:
+    bool should_log(uint64_t n, uint64_t& suppressed) {
+        const uint64_t count = count_.fetch_add(1, std::memory_order_relaxed);
+        if (n <= 1) {
+            suppressed = 0;
+            return true;
+        }
+        if (count % n != 0) {
+            return false;
+        }
+        suppressed = count == 0 ? 0 : n - 1;
+        return true;
+    }
+
+private:
+    std::atomic<uint64_t> count_{0};
+};
+
+// 每个时间窗口最多输出一次，窗口内的调用计入抑制次数
+class LogEveryMs {
+public:
+    bool should_log(int64_t interval_ms, uint64_t& suppressed) {
+        const int64_t now = std::chrono::duration_cast<std::chrono::nanoseconds>(
+            std::chrono::steady_clock::now().time_since_epoch()).count();
+        int64_t next = next_ns_.load(std::memory_order_relaxed);
+        // 并发时只有一个线程能推进窗口，其余线程计入抑制
+        if (now < next ||
+            !next_ns_.compare_exchange_strong(next, now + interval_ms * 1000000, std::memory_order_relaxed)) {
+            suppressed_.fetch_add(1, std::memory_order_relaxed);
+            return false;
+        }
+        suppressed = suppressed_.exchange(0, std::memory_order_relaxed);
+        return true;
+    }
+
+private:
+    std::atomic<int64_t> next_ns_{0};
+    std::atomic<uint64_t> suppressed_{0};
+};
+
+} // namespace proj_logger
+
+#endif // PROJ_RATE_LIMIT_H
@@ -0,0 +1,54 @@
+#include "structured_log.h"
+#include <chrono>
+#include <cstring>
+#include <ctime>
+
+namespace proj_logger {
+
+const char kStructuredFuncname[] = "slog";
+
+spdlog::memory_buf_t& structured_buffer() {
+    thread_local spdlog::memory_buf_t buffer;
+    return buffer;
+}
+
+void JsonLineFormatter::format(const spdlog::details::log_msg& msg, spdlog::memory_buf_t& dest) {
+    JsonEncoder encoder(dest);
+
+    const auto ns = std::chrono::duration_cast<std::chrono::nanoseconds>(msg.time.time_since_epoch()).count();
+    std::time_t secs = static_cast<std::time_t>(ns / 1000000000);
+    std::tm tm_buf;
+    localtime_r(&secs, &tm_buf);
+    char time_str[32];
+    size_t len = std::strftime(time_str, sizeof(time_str), "%Y-%m-%dT%H:%M:%S", &tm_buf);
+    fmt::format_to(std::back_inserter(dest), "{{\"ts\":\"{}.{:06d}\",\"level\":",
+                   std::string_view(time_str, len), static_cast<int>((ns / 1000) % 1000000));
+    auto level_name = spdlog::level::to_string_view(msg.level);
+    encoder.write_string(std::string_view(level_name.data(), level_name.size()));
+    dest.append(std::string_view(",\"logger\":"));
+    encoder.write_string(std::string_view(msg.logger_name.data(), msg.logger_name.size()));
+    if (!msg.source.empty()) {
+        const char* slash = std::strrchr(msg.source.filename, '/');
+        dest.append(std::string_view(",\"src\":"));
+        encoder.write_string(slash ? slash + 1 : msg.source.filename);
+        fmt::format_to(std::back_inserter(dest), ",\"line\":{}", msg.source.line);
+    }
+
+    std::string_view payload(msg.payload.data(), msg.payload.size());
+    if (is_structured(msg) && payload.size() > 1 && payload.front() == '{') {
+        // 结构化正文：去掉开头的 '{'，字段并入外层对象
+        dest.push_back(',');
+        dest.append(payload.data() + 1, payload.data() + payload.size());
+    } else {
+        dest.append(std::string_view(",\"msg\":"));
+        encoder.write_string(payload);
+        dest.push_back('}');
+    }
+    dest.push_back('\n');
+}
+
+std::unique_ptr<spdlog::formatter> JsonLineFormatter::clone() const {
+    return std::make_unique<JsonLineFormatter>();
+}
+
+} // namespace proj_logger
@@ -0,0 +1,179 @@
+// structured_log.h
+#ifndef PROJ_STRUCTURED_LOG_H
+#define PROJ_STRUCTURED_LOG_H
+
+#include <cmath>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <string_view>
+#include <type_traits>
+#include <vector>
+#include <spdlog/spdlog.h>
+#include <spdlog/fmt/fmt.h>
+#include <spdlog/formatter.h>
+
+// 结构化日志：调用点传入类型化的键值字段，编码为JSON对象作为日志正文
+// 正文形如 {"event":"OpAdd","impl":"default","name":"add_0"}，日志处理方无需正则解析
+// 编码写入线程内复用的缓冲区，预热后每条记录不再分配堆内存
+namespace proj_logger {
+
+enum class LogLevel : int32_t;
+
+// 键值字段（只持有引用，在调用表达式内有效）
+template <typename T>
+struct LogField {
+    std::string_view key;
+    const T& value;
+};
+
+template <typename T>
+LogField<T> kv(std::string_view key, const T& value) {
+    return LogField<T>{key, value};
+}
+
+// 区间的投影视图：编码为JSON数组时对每个元素取投影后写出，无需先物化成临时容器
+template <typename Range, typename Proj>
+struct ProjectedRange {
+    const Range& range;
+    Proj proj;
+};
+
+// 例：kv("names", projected(events, &TensorEvent::name))
+template <typename Range, typename Proj>
+ProjectedRange<Range, Proj> projected(const Range& range, Proj proj) {
+    return ProjectedRange<Range, Proj>{range, std::move(proj)};
+}
+
+// 结构化正文的固定前缀
+constexpr std::string_view kStructuredPrefix = "{\"event\":";
+
+// 结构化记录标记：slog 写出的记录以它作为 source_loc::funcname（按地址比较）
+// 标记随 log_msg 经过异步队列、线程环等后端，JSON行格式化器据此识别结构化正文，不从正文内容推断
+extern const char kStructuredFuncname[];
+
+inline bool is_structured(const spdlog::details::log_msg& msg) {
+    return msg.source.funcname == kStructuredFuncname;
+}
+
+// JSON编码器：追加写入外部缓冲区
+class JsonEncoder {
+public:
+    explicit JsonEncoder(spdlog::memory_buf_t& buf) : buf_(buf) {}
+
+    void begin(std::string_view event) {
+        buf_.append(kStructuredPrefix.data(), kStructuredPrefix.data() + kStructuredPrefix.size());
+        write_string(event);
+    }
+
+    template <typename T>
+    void field(std::string_view key, const T& value) {
+        buf_.push_back(',');
+        write_string(key);
+        buf_.push_back(':');
+        write_value(value);
+    }
+
+    void end() { buf_.push_back('}'); }
+
+    // 写JSON字符串（带引号与转义）
+    void write_string(std::string_view s) {
+        buf_.push_back('"');
+        for (char c : s) {
+            switch (c) {
+                case '"': append("\\\""); break;
+                case '\\': append("\\\\"); break;
+                case '\n': append("\\n"); break;
+                case '\r': append("\\r"); break;
+                case '\t': append("\\t"); break;
+                default:
+                    if (static_cast<unsigned char>(c) < 0x20) {
+                        fmt::format_to(std::back_inserter(buf_), "\\u{:04x}", static_cast<unsigned>(c));
+                    } else {
+                        buf_.push_back(c);
+                    }
+            }
+        }
+        buf_.push_back('"');
+    }
+
+private:
+    void append(std::string_view s) { buf_.append(s.data(), s.data() + s.size()); }
+
+    template <typename T>
+    void write_value(const T& value) {
+        if constexpr (std::is_same_v<T, bool>) {
+            append(value ? "true" : "false");
+        } else if constexpr (std::is_same_v<T, char>) {
+            write_string(std::string_view(&value, 1));
+        } else if constexpr (std::is_integral_v<T>) {
+            fmt::format_to(std::back_inserter(buf_), "{}", value);
+        } else if constexpr (std::is_floating_point_v<T>) {
+            if (std::isfinite(value)) {
+                fmt::format_to(std::back_inserter(buf_), "{}", value);
+            } else {
+                append("null");
+            }
+        } else if constexpr (std::is_convertible_v<const T&, std::string_view>) {
+            write_string(std::string_view(value));
+        } else if constexpr (std::is_same_v<T, std::nullptr_t>) {
+            append("null");
+        } else {
+            write_array(value);
+        }
+    }
+
+    // 任意可遍历区间（vector、Span等）
+    template <typename Range>
+    void write_array(const Range& values) {
+        buf_.push_back('[');
+        bool first = true;
+        for (const auto& value : values) {
+            if (!first) buf_.push_back(',');
+            first = false;
+            write_value(value);
+        }
+        buf_.push_back(']');
+    }
+
+    template <typename Range, typename Proj>
+    void write_array(const ProjectedRange<Range, Proj>& values) {
+        buf_.push_back('[');
+        bool first = true;
+        for (const auto& value : values.range) {
+            if (!first) buf_.push_back(',');
+            first = false;
+            write_value(std::invoke(values.proj, value));
+        }
+        buf_.push_back(']');
+    }
+
+    spdlog::memory_buf_t& buf_;
+};
+
+// 当前线程复用的编码缓冲区
+spdlog::memory_buf_t& structured_buffer();
+
+// 编码结构化记录到线程缓冲区，返回的视图在本线程下一次编码前有效
+template <typename... Ts>
+std::string_view encode_structured(std::string_view event, const LogField<Ts>&... fields) {
+    spdlog::memory_buf_t& buf = structured_buffer();
+    buf.clear();
+    JsonEncoder encoder(buf);
+    encoder.begin(event);
+    (encoder.field(fields.key, fields.value), ...);
+    encoder.end();
+    return std::string_view(buf.data(), buf.size());
+}
+
+// JSON行格式化器（PROJ_LOG_FORMAT=json）：每条日志输出一个JSON对象
+// 结构化记录（is_structured）的字段直接并入对象，其余正文一律作为字符串放入 "msg" 字段
+class JsonLineFormatter : public spdlog::formatter {
+public:
+    void format(const spdlog::details::log_msg& msg, spdlog::memory_buf_t& dest) override;
+    std::unique_ptr<spdlog::formatter> clone() const override;
+};
+
+} // namespace proj_logger
+
+#endif // PROJ_STRUCTURED_LOG_H
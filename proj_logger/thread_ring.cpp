@@ -0,0 +1,65 @@
+#include "thread_ring.h"
+#include <algorithm>
+#include <utility>
+#include <spdlog/details/os.h>
+
+namespace proj_logger {
+
+// 注意：编号与线程本地槽位均需外部链接，保证多个动态库共享同一份
+std::atomic<uint64_t> ThreadRingRegistry::next_id_{1};
+
+ThreadRingRegistry::ThreadSlots::~ThreadSlots() {
+    for (auto& slot : slots) {
+        slot.second->closed.store(true, std::memory_order_release);
+    }
+}
+
+ThreadRingRegistry::ThreadSlots& ThreadRingRegistry::thread_slots() {
+    thread_local ThreadSlots slots;
+    return slots;
+}
+
+ThreadRingRegistry::ThreadRingRegistry(size_t ring_capacity)
+    : id_(next_id_.fetch_add(1, std::memory_order_relaxed)),
+      ring_capacity_(ring_capacity) {}
+
+SpscByteRing& ThreadRingRegistry::local_ring() {
+    for (auto& slot : thread_slots().slots) {
+        if (slot.first == id_) {
+            return slot.second->ring;
+        }
+    }
+    return register_current_thread().ring;
+}
+
+ThreadRingRegistry::Entry& ThreadRingRegistry::register_current_thread() {
+    auto entry = std::make_shared<Entry>(ring_capacity_, spdlog::details::os::thread_id());
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        entries_.push_back(entry);
+    }
+    thread_slots().slots.emplace_back(id_, entry);
+    return *entry;
+}
+
+void ThreadRingRegistry::collect(std::vector<std::shared_ptr<Entry>>& out) {
+    out.clear();
+    std::lock_guard<std::mutex> lock(mutex_);
+    entries_.erase(std::remove_if(entries_.begin(), entries_.end(),
+                                  [](const std::shared_ptr<Entry>& e) {
+                                      return e->closed.load(std::memory_order_acquire) && e->ring.empty();
+                                  }),
+                   entries_.end());
+    out = entries_;
+}
+
+size_t ThreadRingRegistry::pending_bytes() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    size_t total = 0;
+    for (const auto& e : entries_) {
+        total += e->ring.used_approx();
+    }
+    return total;
+}
+
+} // namespace proj_logger
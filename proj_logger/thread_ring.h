@@ -0,0 +1,63 @@
+// thread_ring.h
+#ifndef PROJ_THREAD_RING_H
+#define PROJ_THREAD_RING_H
+
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <utility>
+#include <vector>
+#include "spsc_ring.h"
+
+namespace proj_logger {
+
+// 每线程一个SPSC字节环：线程首次写日志时自动创建注册，线程退出时标记关闭
+// 消费者排空已关闭的环后将其回收
+class ThreadRingRegistry {
+public:
+    struct Entry {
+        explicit Entry(size_t capacity, uint64_t tid) : ring(capacity), thread_id(tid) {}
+        SpscByteRing ring;
+        const uint64_t thread_id;      // 所属线程（spdlog线程号）
+        std::atomic<bool> closed{false};
+    };
+
+    explicit ThreadRingRegistry(size_t ring_capacity);
+    ~ThreadRingRegistry() = default;
+
+    ThreadRingRegistry(const ThreadRingRegistry&) = delete;
+    ThreadRingRegistry& operator=(const ThreadRingRegistry&) = delete;
+
+    // 生产者：当前线程的环（首次调用加锁注册，之后无锁）
+    SpscByteRing& local_ring();
+
+    // 消费者：获取所有环的快照，并回收已关闭且已排空的环
+    void collect(std::vector<std::shared_ptr<Entry>>& out);
+
+    // 所有环中待消费的字节数（仅供统计）
+    size_t pending_bytes() const;
+
+    size_t ring_capacity() const { return ring_capacity_; }
+
+private:
+    // 线程本地槽位：记录本线程在各注册表中的环，线程退出时统一标记关闭
+    struct ThreadSlots {
+        std::vector<std::pair<uint64_t, std::shared_ptr<Entry>>> slots;
+        ~ThreadSlots();
+    };
+
+    static ThreadSlots& thread_slots();
+    Entry& register_current_thread();
+
+    static std::atomic<uint64_t> next_id_;
+
+    const uint64_t id_; // 全局唯一编号，区分不同注册表的线程本地槽位
+    const size_t ring_capacity_;
+    mutable std::mutex mutex_;
+    std::vector<std::shared_ptr<Entry>> entries_;
+};
+
+} // namespace proj_logger
+
+#endif // PROJ_THREAD_RING_H
@@ -0,0 +1,229 @@
+#include "thread_ring_sink.h"
+#include <chrono>
+#include <cstddef>
+#include <cstring>
+#include <limits>
+
+namespace proj_logger {
+
+namespace {
+
+// 环内记录头：源码位置指针来自 __FILE__/__func__ 字面量，进程内有效，无需拷贝
+struct RingRecordHeader {
+    int64_t time_ns;
+    uint64_t thread_id;
+    const char* filename;
+    const char* funcname;
+    int32_t line;
+    int32_t level;
+    uint32_t name_len;
+    uint32_t payload_len;
+};
+
+// 单轮最多归并的记录数，避免持续写入的线程饿死flush
+constexpr size_t kMaxRecordsPerPass = 4096;
+
+} // namespace
+
+ThreadRingSink::ThreadRingSink(std::shared_ptr<spdlog::sinks::sink> inner, size_t ring_bytes,
+                               OverflowPolicy policy)
+    : inner_(std::move(inner)),
+      rings_(ring_bytes),
+      policy_(policy) {
+    worker_ = std::thread([this]() { worker_loop(); });
+}
+
+ThreadRingSink::~ThreadRingSink() {
+    shutdown();
+}
+
+void ThreadRingSink::log(const spdlog::details::log_msg& msg) {
+    // 先登记为在途生产者再检查停止标志（均为seq_cst），与 AsyncSink 相同：
+    // shutdown 要么等到本次提交完成后再最后排空，要么本次看到停止标志走同步写
+    // 计数分条，热路径只修改本线程的槽，不引入跨线程共享写
+    StripedCounter::Slot& slot = producers_.enter();
+    struct ProducerGuard {
+        StripedCounter::Slot& slot;
+        ~ProducerGuard() { StripedCounter::leave(slot); }
+    } guard{slot};
+
+    if (stopping_.load(std::memory_order_seq_cst)) {
+        inner_->log(msg);
+        written_.fetch_add(1, std::memory_order_relaxed);
+        return;
+    }
+
+    RingRecordHeader header;
+    header.time_ns = std::chrono::duration_cast<std::chrono::nanoseconds>(
+        msg.time.time_since_epoch()).count();
+    header.thread_id = msg.thread_id;
+    header.filename = msg.source.filename;
+    header.funcname = msg.source.funcname;
+    header.line = msg.source.line;
+    header.level = static_cast<int32_t>(msg.level);
+    header.name_len = static_cast<uint32_t>(msg.logger_name.size());
+    header.payload_len = static_cast<uint32_t>(msg.payload.size());
+
+    const size_t size = sizeof(header) + header.name_len + header.payload_len;
+    SpscByteRing& ring = rings_.local_ring();
+    uint8_t* p = ring.reserve(size);
+    while (p == nullptr) {
+        if (policy_ != OverflowPolicy::BLOCK || size > ring.capacity() / 2) {
+            dropped_.fetch_add(1, std::memory_order_relaxed);
+            return;
+        }
+        // 消费线程可能已随 shutdown() 退出，环不会再被清空：与入口处一致直接写下游
+        if (stopping_.load(std::memory_order_acquire)) {
+            inner_->log(msg);
+            written_.fetch_add(1, std::memory_order_relaxed);
+            return;
+        }
+        std::this_thread::yield();
+        p = ring.reserve(size);
+    }
+    std::memcpy(p, &header, sizeof(header));
+    p += sizeof(header);
+    std::memcpy(p, msg.logger_name.data(), header.name_len);
+    p += header.name_len;
+    std::memcpy(p, msg.payload.data(), header.payload_len);
+    ring.commit();
+}
+
+void ThreadRingSink::worker_loop() {
+    while (!stopping_.load(std::memory_order_acquire)) {
+        if (drain_once() == 0) {
+            // 调用线程不做唤醒（热路径只写本线程环），空闲时短暂休眠轮询
+            std::this_thread::sleep_for(std::chrono::milliseconds(1));
+        }
+    }
+}
+
+size_t ThreadRingSink::drain_once(const DrainTargets* targets) {
+    std::lock_guard<std::mutex> lock(drain_mutex_);
+    rings_.collect(entries_);
+
+    // 各环队首记录；每次取时间戳最小者写出，实现跨线程按时间归并
+    struct Head {
+        const uint8_t* data = nullptr;
+        RingRecordHeader header;
+        bool bounded = false;
+        size_t limit = 0;
+    };
+    std::vector<Head> heads(entries_.size());
+    if (targets != nullptr) {
+        for (size_t i = 0; i < entries_.size(); ++i) {
+            heads[i].bounded = true;
+            heads[i].limit = entries_[i]->ring.read_position(); // flush 之后才注册的环不读
+            for (const auto& target : *targets) {
+                if (target.first == entries_[i]) {
+                    heads[i].limit = target.second;
+                    break;
+                }
+            }
+        }
+    }
+    auto load_head = [&](size_t i) {
+        // 后台线程可能已越过终点继续读取，按单调位置比较
+        if (heads[i].bounded &&
+            static_cast<std::ptrdiff_t>(entries_[i]->ring.read_position() - heads[i].limit) >= 0) {
+            heads[i].data = nullptr;
+            return;
+        }
+        size_t len = 0;
+        heads[i].data = entries_[i]->ring.peek(len);
+        if (heads[i].data != nullptr) {
+            std::memcpy(&heads[i].header, heads[i].data, sizeof(RingRecordHeader));
+        }
+    };
+    for (size_t i = 0; i < entries_.size(); ++i) {
+        load_head(i);
+    }
+
+    size_t count = 0;
+    while (count < kMaxRecordsPerPass) {
+        size_t best = heads.size();
+        int64_t best_ts = std::numeric_limits<int64_t>::max();
+        for (size_t i = 0; i < heads.size(); ++i) {
+            if (heads[i].data != nullptr && heads[i].header.time_ns < best_ts) {
+                best = i;
+                best_ts = heads[i].header.time_ns;
+            }
+        }
+        if (best == heads.size()) {
+            break;
+        }
+
+        const RingRecordHeader& h = heads[best].header;
+        const char* name = reinterpret_cast<const char*>(heads[best].data + sizeof(RingRecordHeader));
+        const char* payload = name + h.name_len;
+        const auto log_time = spdlog::log_clock::time_point(
+            std::chrono::duration_cast<spdlog::log_clock::duration>(std::chrono::nanoseconds(h.time_ns)));
+        spdlog::details::log_msg msg(log_time, spdlog::source_loc(h.filename, h.line, h.funcname),
+                                     spdlog::string_view_t(name, h.name_len),
+                                     static_cast<spdlog::level::level_enum>(h.level),
+                                     spdlog::string_view_t(payload, h.payload_len));
+        msg.thread_id = static_cast<size_t>(h.thread_id);
+        inner_->log(msg);
+
+        entries_[best]->ring.release();
+        load_head(best);
+        ++count;
+    }
+
+    if (count > 0) {
+        inner_->flush();
+        written_.fetch_add(count, std::memory_order_relaxed);
+    }
+    return count;
+}
+
+void ThreadRingSink::flush() {
+    // 记录各环当前写位置作为终点，只写出 flush 调用前已提交的记录
+    DrainTargets targets;
+    {
+        std::lock_guard<std::mutex> lock(drain_mutex_);
+        rings_.collect(entries_);
+        targets.reserve(entries_.size());
+        for (const auto& entry : entries_) {
+            targets.emplace_back(entry, entry->ring.write_position());
+        }
+    }
+    while (drain_once(&targets) > 0) {
+    }
+    inner_->flush();
+}
+
+void ThreadRingSink::set_pattern(const std::string& pattern) {
+    inner_->set_pattern(pattern);
+}
+
+void ThreadRingSink::set_formatter(std::unique_ptr<spdlog::formatter> sink_formatter) {
+    inner_->set_formatter(std::move(sink_formatter));
+}
+
+void ThreadRingSink::shutdown() {
+    if (stopping_.exchange(true, std::memory_order_seq_cst)) {
+        return;
+    }
+    if (worker_.joinable()) {
+        worker_.join();
+    }
+    // 等待停止标志生效前已进入 log() 的生产者提交完成；之后生产者改为同步写，环不再增长，可以排空到底
+    while (!producers_.is_zero()) {
+        std::this_thread::yield();
+    }
+    while (drain_once() > 0) {
+    }
+    inner_->flush();
+}
+
+AsyncSinkStats ThreadRingSink::stats() const {
+    AsyncSinkStats result;
+    result.written = written_.load(std::memory_order_relaxed);
+    result.dropped = dropped_.load(std::memory_order_relaxed);
+    result.queue_depth = rings_.pending_bytes();
+    result.queue_capacity = rings_.ring_capacity();
+    return result;
+}
+
+} // namespace proj_logger
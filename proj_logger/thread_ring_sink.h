@@ -0,0 +1,68 @@
+// thread_ring_sink.h
+#ifndef PROJ_THREAD_RING_SINK_H
+#define PROJ_THREAD_RING_SINK_H
+
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <utility>
+#include <vector>
+#include <spdlog/sinks/sink.h>
+#include "async_sink.h"
+#include "thread_ring.h"
+#include "striped_counter.h"
+
+namespace proj_logger {
+
+// 每线程SPSC环sink：调用线程把日志记录写入自己的环（无共享锁、无共享原子写），
+// 单个后台线程按时间戳归并各线程的记录后写入下游sink
+// 归并只在单轮排空内有序：跨轮次到达的晚提交记录可能早于已写出的记录
+// 线程首次写日志时自动注册环，线程退出后环被排空并回收
+class ThreadRingSink : public spdlog::sinks::sink {
+public:
+    // policy：环满时 BLOCK 等待后台排空，DROP_NEWEST/DROP_OLDEST 均丢弃新记录（SPSC环只能由消费者出队）
+    ThreadRingSink(std::shared_ptr<spdlog::sinks::sink> inner, size_t ring_bytes, OverflowPolicy policy);
+    ~ThreadRingSink() override;
+
+    ThreadRingSink(const ThreadRingSink&) = delete;
+    ThreadRingSink& operator=(const ThreadRingSink&) = delete;
+
+    void log(const spdlog::details::log_msg& msg) override;
+    // 同步写出调用时各环中已提交的记录后flush下游（之后新写入的记录留给后台线程，持续写入时不会阻塞调用方）
+    void flush() override;
+    void set_pattern(const std::string& pattern) override;
+    void set_formatter(std::unique_ptr<spdlog::formatter> sink_formatter) override;
+
+    // 等待在途的 log() 提交完成后排空所有环并停止后台线程；之后的日志同步写入下游
+    void shutdown();
+
+    // queue_depth 为各线程环中待写出的字节数
+    AsyncSinkStats stats() const;
+
+private:
+    // flush 的排空终点：各环在 flush 开始时的写位置
+    using DrainTargets = std::vector<std::pair<std::shared_ptr<ThreadRingRegistry::Entry>, size_t>>;
+
+    void worker_loop();
+    // 归并写出一轮；指定 targets 时每个环只读到其终点，不在 targets 中的环跳过
+    size_t drain_once(const DrainTargets* targets = nullptr);
+
+    std::shared_ptr<spdlog::sinks::sink> inner_;
+    ThreadRingRegistry rings_;
+    const OverflowPolicy policy_;
+
+    std::atomic<uint64_t> written_{0};
+    std::atomic<uint64_t> dropped_{0};
+    std::atomic<bool> stopping_{false};
+    StripedCounter producers_;  // 正在 log() 中写环的生产者（分条计数）
+
+    std::mutex drain_mutex_;  // 后台线程与flush互斥排空
+    std::vector<std::shared_ptr<ThreadRingRegistry::Entry>> entries_;
+    std::thread worker_;
+};
+
+} // namespace proj_logger
+
+#endif // PROJ_THREAD_RING_SINK_H
@@ -2,17 +2,36 @@
 #include "../proj/front/front.h"
 #include "../proj/back/back.h"
 #include "../engine_base/no_copy_move.h"
+#include "../engine_base/inline_function.h"
+#include "../engine_base/work_stealing_executor.h"
+#include "../engine_base/sharded_executor.h"
+#include "../engine_base/object_pool.h"
+#include "../engine_base/symbol.h"
 #include <gtest/gtest.h>
 #include <type_traits> // 必须包含类型特性头文件
 
 #include "../handler/api_base.h"
 #include "../handler/api_base_single.h"
 #include "../handler/router.h"
+#include "../handler/static_router.h"
 #include <any>
+#include <array>
+#include <deque>
+#include <set>
 #include <string>
 #include <chrono>
 #include <thread>
 #include <atomic>
+#include <sstream>
+#include <fstream>
+#include <iterator>
+#include <unistd.h>
+#include <sys/stat.h>
+#include <csignal>
+#include <algorithm>
+#include <future>
+#include <spdlog/sinks/base_sink.h>
+#include <spdlog/sinks/ostream_sink.h>
 
 namespace proj_test {
 // ========== 测试1：继承nocopy（仅禁用拷贝，允许移动） ==========
@@ -82,6 +101,767 @@ TEST(ProjTest, CopyMoveTest) {
     TEST_WARN("CopyMoveTest finished");
 }
 
+// 内联可调用对象：仅可移动，捕获存放在内部缓冲区，移动/析构正确管理捕获对象
+TEST(ProjTest, InlineFunctionTest) {
+    using Func = InlineFunction<int(int)>;
+    static_assert(!std::is_copy_constructible_v<Func>, "InlineFunction should be move-only");
+    static_assert(std::is_nothrow_move_constructible_v<Func>, "InlineFunction move should be noexcept");
+
+    Func empty;
+    EXPECT_FALSE(empty);
+
+    int base = 10;
+    Func add([&base](int x) { return base + x; });
+    ASSERT_TRUE(add);
+    EXPECT_EQ(add(5), 15);
+
+    // 可变状态保存在内联缓冲区，移动后继续生效
+    Func counter([n = 0](int x) mutable { return n += x; });
+    EXPECT_EQ(counter(1), 1);
+    Func moved = std::move(counter);
+    EXPECT_FALSE(counter);
+    EXPECT_EQ(moved(2), 3);
+
+    // 捕获对象随InlineFunction析构/重新赋值而释放
+    auto tracker = std::make_shared<int>(7);
+    {
+        Func holder([tracker](int x) { return *tracker + x; });
+        EXPECT_EQ(tracker.use_count(), 2);
+        Func other = std::move(holder);
+        EXPECT_EQ(tracker.use_count(), 2);
+        EXPECT_EQ(other(1), 8);
+        other = nullptr;
+        EXPECT_EQ(tracker.use_count(), 1);
+    }
+    EXPECT_EQ(tracker.use_count(), 1);
+}
+
+// 字符串驻留：相同内容得到同一符号，多线程并发驻留结果一致；事件名称不进入驻留表
+TEST(ProjTest, SymbolInterning) {
+    Symbol a("tensor_0");
+    Symbol b(std::string("tensor_") + "0");
+    EXPECT_EQ(a, b);
+    EXPECT_NE(a, Symbol("tensor_1"));
+    EXPECT_EQ(a.str(), "tensor_0");
+    EXPECT_TRUE(Symbol("").empty());
+    EXPECT_EQ(Symbol().str(), "");
+
+    constexpr int kThreads = 4;
+    constexpr int kNames = 500;
+    std::vector<std::vector<uint32_t>> ids(kThreads, std::vector<uint32_t>(kNames));
+    std::vector<std::thread> threads;
+    for (int t = 0; t < kThreads; ++t) {
+        threads.emplace_back([&, t]() {
+            for (int i = 0; i < kNames; ++i) {
+                ids[t][i] = Symbol("sym_concurrent_" + std::to_string(i)).id();
+            }
+        });
+    }
+    for (auto& t : threads) {
+        t.join();
+    }
+    for (int t = 1; t < kThreads; ++t) {
+        EXPECT_EQ(ids[t], ids[0]);
+    }
+    EXPECT_EQ(SymbolTable::global().text(ids[0][7]), "sym_concurrent_7");
+
+    // 只查找不插入：未驻留的名字得到空符号，且查找后仍未驻留
+    const size_t before = SymbolTable::global().size();
+    EXPECT_EQ(Symbol::lookup("tensor_0"), a);
+    EXPECT_TRUE(Symbol::lookup("sym_never_interned").empty());
+    EXPECT_EQ(SymbolTable::global().size(), before);
+
+    // 事件与消息按字符串保存名字，构造时不查驻留表；name_symbol() 按需查找，不驻留
+    proj::event::OpAddEvent event("add_never_interned", "tensor_0", "tensor_1", "tensor_0");
+    proj::msg::OpAddMsg msg("msg_never_interned", "tensor_0", "tensor_1", "tensor_0");
+    EXPECT_TRUE(event.name_symbol().empty());
+    EXPECT_TRUE(msg.name_symbol().empty());
+    EXPECT_EQ(SymbolTable::global().size(), before);
+
+    // 对象池复用时 assign 之后按新名字查找
+    event.assign("tensor_0", "add_never_interned", "tensor_1", "tensor_1");
+    EXPECT_EQ(event.name_symbol(), a);
+}
+
+// 对象池：回收的事件通过assign重新赋值并保留容器容量；跨线程回收的对象经全局仓库回到生产线程
+TEST(ProjTest, ObjectPoolRecyclesEvents) {
+    using Pool = ObjectPool<proj::event::OpAddEvent, 4>;
+    const proj::event::OpAddEvent* first = nullptr;
+    const std::string long_name(64, 'x');
+    {
+        auto event = Pool::make(long_name, "t0", "t1", "t2");
+        first = event.get();
+    }
+    EXPECT_EQ(Pool::cached(), 1u);
+
+    auto reused = Pool::make("add_1", "a", "b", "c");
+    EXPECT_EQ(reused.get(), first);
+    EXPECT_EQ(reused->name(), "add_1");
+    EXPECT_EQ(reused->output(), "c");
+    EXPECT_GE(reused->name().capacity(), long_name.size()); // 容量保留
+
+    const std::vector<int64_t> big_shape(64, 2);
+    ObjectPool<proj::event::TensorEvent>::make("t", big_shape, "float32").reset();
+    auto tensor = ObjectPool<proj::event::TensorEvent>::make("t", std::vector<int64_t>{1}, "float32");
+    EXPECT_EQ(tensor->shape().size(), 1u);
+    EXPECT_GE(tensor->shape().capacity(), big_shape.size()); // 容量保留
+    reused.reset();
+
+    // 生产线程取用，消费线程回收：超出线程缓存的部分整批进入仓库，生产线程再从仓库取回
+    std::vector<Pool::Ptr> events;
+    std::vector<const proj::event::OpAddEvent*> produced;
+    for (int i = 0; i < 16; ++i) {
+        events.push_back(Pool::make("add", "a", "b", "c"));
+        produced.push_back(events.back().get());
+    }
+    std::thread consumer([&]() { events.clear(); });
+    consumer.join();
+    EXPECT_EQ(Pool::cached(), 0u);
+    auto from_depot = Pool::make("add_2", "a", "b", "c");
+    EXPECT_NE(std::find(produced.begin(), produced.end(), from_depot.get()), produced.end());
+    EXPECT_EQ(from_depot->name(), "add_2");
+}
+
+// 级别不满足时，宏不应对参数求值
+TEST(ProjLoggerTest, DisabledLevelSkipsArgumentEvaluation) {
+    if (proj_logger::LoggerManager::get_instance().flight_recorder_enabled()) {
+        GTEST_SKIP() << "flight recorder keeps levels below output level";
+    }
+    proj_logger::set_global_log_level(proj_logger::LogLevel::INFO);
+    int evaluated = 0;
+    auto count = [&]() { return ++evaluated; };
+
+    PROJ_DEBG("debug arg {}", count());
+    EXPECT_EQ(evaluated, 0);
+
+#if PROJ_LOG_ACTIVE_LEVEL <= PROJ_LOG_LEVEL_INFO
+    PROJ_INFO("info arg {}", count());
+    EXPECT_EQ(evaluated, 1);
+#endif
+}
+
+// 按模块设置级别，并通过级别文件+SIGHUP在运行时重新加载
+TEST(ProjLoggerTest, PerModuleLevelsAndReload) {
+    auto& manager = proj_logger::LoggerManager::get_instance();
+    manager.set_log_levels("warn, TEST=debug");
+    EXPECT_EQ(manager.module_log_level(TEST_LOGGER_NAME), spdlog::level::debug);
+    EXPECT_EQ(manager.module_log_level(PROJ_LOGGER_NAME), spdlog::level::warn);
+
+    int evaluated = 0;
+    auto count = [&]() { return ++evaluated; };
+    TEST_INFO("module debug {}", count());
+    EXPECT_EQ(evaluated, 1);
+    if (!manager.flight_recorder_enabled()) {
+        PROJ_INFO("module warn {}", count());
+        EXPECT_EQ(evaluated, 1);
+    }
+
+    const std::string path = ::testing::TempDir() + "ut_levels_" + std::to_string(::getpid()) + ".conf";
+    auto wait_level = [&](const char* name, spdlog::level::level_enum level) {
+        for (int i = 0; i < 100 && manager.module_log_level(name) != level; ++i) {
+            std::this_thread::sleep_for(std::chrono::milliseconds(20));
+        }
+        return manager.module_log_level(name);
+    };
+    // 宿主程序自己的SIGHUP处理函数：监视期间被链式调用，停止监视后恢复
+    static std::atomic<int> host_sighups{0};
+    struct sigaction host{};
+    struct sigaction original{};
+    host.sa_handler = [](int) { host_sighups.fetch_add(1); };
+    sigemptyset(&host.sa_mask);
+    ASSERT_EQ(::sigaction(SIGHUP, &host, &original), 0);
+
+    std::ofstream(path) << "PROJ=error\n";
+    manager.watch_level_file(path);
+    EXPECT_EQ(manager.module_log_level(PROJ_LOGGER_NAME), spdlog::level::err);
+
+    // 内容不变时只有SIGHUP能触发重新加载：先把级别改掉再发信号
+    manager.set_module_log_level(PROJ_LOGGER_NAME, spdlog::level::trace);
+    std::raise(SIGHUP);
+    EXPECT_EQ(wait_level(PROJ_LOGGER_NAME, spdlog::level::err), spdlog::level::err);
+    EXPECT_EQ(host_sighups.load(), 1);
+
+    std::ofstream(path) << "PROJ=debug\nhand=critical\n";
+    EXPECT_EQ(wait_level("hand", spdlog::level::critical), spdlog::level::critical);
+    EXPECT_EQ(manager.module_log_level(PROJ_LOGGER_NAME), spdlog::level::debug);
+
+    manager.watch_level_file("");
+    struct sigaction current{};
+    ::sigaction(SIGHUP, nullptr, &current);
+    EXPECT_EQ(current.sa_handler, host.sa_handler);
+    ::sigaction(SIGHUP, &original, nullptr);
+    std::remove(path.c_str());
+    proj_logger::set_global_log_level(proj_logger::LogLevel::INFO);
+}
+
+// 限流宏：每N次/每个时间窗口最多输出一次，被抑制的调用不对参数求值
+TEST(ProjLoggerTest, RateLimitedMacros) {
+    proj_logger::set_global_log_level(proj_logger::LogLevel::INFO);
+    int evaluated = 0;
+    auto count = [&]() { return ++evaluated; };
+
+    for (int i = 0; i < 1000; ++i) {
+        PROJ_WARN_EVERY_N(100, "every n {}", count());
+    }
+    EXPECT_EQ(evaluated, 10);
+
+    evaluated = 0;
+    for (int i = 0; i < 1000; ++i) {
+        PROJ_WARN_EVERY_MS(60000, "every ms {}", count());
+    }
+    EXPECT_EQ(evaluated, 1);
+
+    // 抑制次数在下一次输出时汇总
+    proj_logger::LogEveryMs limiter;
+    uint64_t suppressed = 0;
+    EXPECT_TRUE(limiter.should_log(20, suppressed));
+    EXPECT_EQ(suppressed, 0u);
+    for (int i = 0; i < 5; ++i) {
+        EXPECT_FALSE(limiter.should_log(20, suppressed));
+    }
+    std::this_thread::sleep_for(std::chrono::milliseconds(30));
+    EXPECT_TRUE(limiter.should_log(20, suppressed));
+    EXPECT_EQ(suppressed, 5u);
+}
+
+// 结构化日志：字段编码为JSON正文；JSON行格式化器把字段并入外层对象，普通文本放入msg
+TEST(ProjLoggerTest, StructuredKeyValueLogging) {
+    std::ostringstream oss;
+    auto sink = std::make_shared<spdlog::sinks::ostream_sink_mt>(oss);
+    spdlog::logger logger("kv", sink);
+    logger.set_pattern("%v");
+
+    const std::string name = "add_\"0\"";
+    const std::vector<int64_t> shape = {2, 3};
+    proj_logger::slog(&logger, proj_logger::LogLevel::INFO, __FILE__, __LINE__, "OpAdd",
+                      proj_logger::kv("name", name), proj_logger::kv("shape", shape),
+                      proj_logger::kv("ok", true), proj_logger::kv("ratio", 0.5));
+    EXPECT_EQ(oss.str(), "{\"event\":\"OpAdd\",\"name\":\"add_\\\"0\\\"\",\"shape\":[2,3],"
+                         "\"ok\":true,\"ratio\":0.5}\n");
+
+    // 线程缓冲区复用：同样大小的记录不再重新分配
+    const char* data = proj_logger::structured_buffer().data();
+    proj_logger::encode_structured("OpAdd", proj_logger::kv("name", name), proj_logger::kv("shape", shape));
+    EXPECT_EQ(proj_logger::structured_buffer().data(), data);
+
+    // 区间按投影逐个编码为数组，不物化中间容器
+    const proj::event::TensorEvent tensors[] = {{"t0", {1}, "float32"}, {"t\"1", {2}, "int8"}};
+    EXPECT_EQ(proj_logger::encode_structured(
+                  "Batch", proj_logger::kv("names", proj_logger::projected(
+                                                        Span<const proj::event::TensorEvent>(tensors),
+                                                        &proj::event::TensorEvent::name))),
+              "{\"event\":\"Batch\",\"names\":[\"t0\",\"t\\\"1\"]}");
+
+    oss.str("");
+    logger.set_formatter(std::make_unique<proj_logger::JsonLineFormatter>());
+    proj_logger::slog(&logger, proj_logger::LogLevel::WARN, "dir/router.h", 7, "OpMMA",
+                      proj_logger::kv("name", "mma_0"));
+    logger.info("plain\ttext");
+    // 普通文本即使以结构化前缀开头也按字符串转义，不并入对象
+    logger.info("{\"event\": \"fake\"");
+    std::string out = oss.str();
+    EXPECT_NE(out.find("\"level\":\"warning\",\"logger\":\"kv\",\"src\":\"router.h\",\"line\":7,"
+                       "\"event\":\"OpMMA\",\"name\":\"mma_0\"}\n"), std::string::npos) << out;
+    EXPECT_NE(out.find("\"level\":\"info\",\"logger\":\"kv\",\"msg\":\"plain\\ttext\"}\n"), std::string::npos) << out;
+    EXPECT_NE(out.find("\"msg\":\"{\\\"event\\\": \\\"fake\\\"\"}\n"), std::string::npos) << out;
+}
+
+// 可阻塞的下游sink：模拟慢速终端，用于制造队列积压
+class GateSink : public spdlog::sinks::base_sink<std::mutex> {
+public:
+    std::atomic<bool> open{true};
+    std::atomic<int> count{0};
+
+protected:
+    void sink_it_(const spdlog::details::log_msg&) override {
+        while (!open.load()) {
+            std::this_thread::yield();
+        }
+        count++;
+    }
+    void flush_() override {}
+};
+
+// 异步sink：消息全部写出，flush后统计准确
+TEST(ProjLoggerTest, AsyncSinkWritesAllMessages) {
+    std::ostringstream oss;
+    auto inner = std::make_shared<spdlog::sinks::ostream_sink_mt>(oss);
+    auto async = std::make_shared<proj_logger::AsyncSink>(inner, 64, proj_logger::OverflowPolicy::BLOCK, 8);
+    spdlog::logger logger("async_test", async);
+    logger.set_pattern("%v");
+
+    const int kThreadCount = 4;
+    const int kMsgsPerThread = 100;
+    std::vector<std::thread> threads;
+    for (int t = 0; t < kThreadCount; ++t) {
+        threads.emplace_back([&, t]() {
+            for (int i = 0; i < kMsgsPerThread; ++i) {
+                logger.info("t{} m{}", t, i);
+            }
+        });
+    }
+    for (auto& t : threads) {
+        t.join();
+    }
+    logger.flush();
+
+    auto stats = async->stats();
+    EXPECT_EQ(stats.written, static_cast<uint64_t>(kThreadCount * kMsgsPerThread));
+    EXPECT_EQ(stats.dropped, 0u);
+    EXPECT_EQ(stats.queue_depth, 0u);
+    std::string out = oss.str();
+    EXPECT_EQ(std::count(out.begin(), out.end(), '\n'), kThreadCount * kMsgsPerThread);
+}
+
+// 异步sink：队列满时按策略丢弃，析构前排空
+TEST(ProjLoggerTest, AsyncSinkOverflowPolicy) {
+    for (auto policy : {proj_logger::OverflowPolicy::DROP_NEWEST, proj_logger::OverflowPolicy::DROP_OLDEST}) {
+        auto inner = std::make_shared<GateSink>();
+        inner->open = false;
+        auto async = std::make_shared<proj_logger::AsyncSink>(inner, 4, policy, 1);
+        spdlog::logger logger("async_overflow", async);
+
+        const int kMsgs = 64;
+        for (int i = 0; i < kMsgs; ++i) {
+            logger.info("overflow {}", i);
+        }
+        EXPECT_GT(async->stats().dropped, 0u) << proj_logger::cvtOverflowPolicy(policy);
+
+        inner->open = true;
+        async->shutdown();
+        auto stats = async->stats();
+        EXPECT_EQ(stats.written + stats.dropped, static_cast<uint64_t>(kMsgs));
+        EXPECT_EQ(static_cast<uint64_t>(inner->count.load()), stats.written);
+    }
+}
+
+// 异步sink：多线程持续写入时停止，停止前后的消息都不丢失（写入+丢弃=提交总数）
+TEST(ProjLoggerTest, AsyncSinkShutdownUnderLoad) {
+    for (auto policy : {proj_logger::OverflowPolicy::BLOCK, proj_logger::OverflowPolicy::DROP_NEWEST,
+                        proj_logger::OverflowPolicy::DROP_OLDEST}) {
+        auto inner = std::make_shared<GateSink>();
+        auto async = std::make_shared<proj_logger::AsyncSink>(inner, 16, policy, 4);
+        spdlog::logger logger("async_shutdown", async);
+
+        const int kThreadCount = 4;
+        std::atomic<bool> stop{false};
+        std::atomic<uint64_t> submitted{0};
+        std::vector<std::thread> threads;
+        for (int t = 0; t < kThreadCount; ++t) {
+            threads.emplace_back([&, t]() {
+                for (int i = 0; !stop.load(); ++i) {
+                    logger.info("t{} m{}", t, i);
+                    submitted.fetch_add(1);
+                }
+            });
+        }
+        while (submitted.load() < 2000) {
+            std::this_thread::yield();
+        }
+        async->shutdown();
+        stop = true;
+        for (auto& t : threads) {
+            t.join();
+        }
+
+        auto stats = async->stats();
+        EXPECT_EQ(stats.written + stats.dropped, submitted.load()) << proj_logger::cvtOverflowPolicy(policy);
+        EXPECT_EQ(static_cast<uint64_t>(inner->count.load()), stats.written);
+        EXPECT_EQ(stats.queue_depth, 0u);
+    }
+}
+
+// 每线程环sink：多线程写入全部送达，同一线程内保持顺序
+TEST(ProjLoggerTest, ThreadRingSinkMergesPerThreadRings) {
+    std::ostringstream oss;
+    auto inner = std::make_shared<spdlog::sinks::ostream_sink_mt>(oss);
+    auto ring_sink = std::make_shared<proj_logger::ThreadRingSink>(inner, 4096, proj_logger::OverflowPolicy::BLOCK);
+    spdlog::logger logger("ring_test", ring_sink);
+    logger.set_pattern("%v");
+
+    const int kThreadCount = 4;
+    const int kMsgsPerThread = 200;
+    std::vector<std::thread> threads;
+    for (int t = 0; t < kThreadCount; ++t) {
+        threads.emplace_back([&, t]() {
+            for (int i = 0; i < kMsgsPerThread; ++i) {
+                logger.info("{} {}", t, i);
+            }
+        });
+    }
+    for (auto& t : threads) {
+        t.join();
+    }
+    logger.flush();
+
+    auto stats = ring_sink->stats();
+    EXPECT_EQ(stats.written, static_cast<uint64_t>(kThreadCount * kMsgsPerThread));
+    EXPECT_EQ(stats.dropped, 0u);
+    EXPECT_EQ(stats.queue_depth, 0u);
+
+    std::istringstream iss(oss.str());
+    std::vector<int> next(kThreadCount, 0);
+    int t = 0, i = 0, lines = 0;
+    while (iss >> t >> i) {
+        ASSERT_GE(t, 0);
+        ASSERT_LT(t, kThreadCount);
+        EXPECT_EQ(i, next[t]++);
+        ++lines;
+    }
+    EXPECT_EQ(lines, kThreadCount * kMsgsPerThread);
+}
+
+// 每线程环sink：多线程持续写入时停止，在途的提交不丢失（写入+丢弃=提交总数）
+TEST(ProjLoggerTest, ThreadRingSinkShutdownUnderLoad) {
+    for (auto policy : {proj_logger::OverflowPolicy::BLOCK, proj_logger::OverflowPolicy::DROP_NEWEST}) {
+        auto inner = std::make_shared<GateSink>();
+        auto ring_sink = std::make_shared<proj_logger::ThreadRingSink>(inner, 4096, policy);
+        spdlog::logger logger("ring_shutdown", ring_sink);
+
+        std::atomic<bool> stop{false};
+        std::atomic<uint64_t> submitted{0};
+        std::vector<std::thread> threads;
+        for (int t = 0; t < 4; ++t) {
+            threads.emplace_back([&, t]() {
+                for (int i = 0; !stop.load(); ++i) {
+                    logger.info("t{} m{}", t, i);
+                    submitted.fetch_add(1);
+                }
+            });
+        }
+        while (submitted.load() < 2000) {
+            std::this_thread::yield();
+        }
+        ring_sink->shutdown();
+        stop = true;
+        for (auto& t : threads) {
+            t.join();
+        }
+
+        auto stats = ring_sink->stats();
+        EXPECT_EQ(stats.written + stats.dropped, submitted.load()) << proj_logger::cvtOverflowPolicy(policy);
+        EXPECT_EQ(static_cast<uint64_t>(inner->count.load()), stats.written);
+    }
+}
+
+// 慢速下游sink：每条记录让出一次CPU（写出慢于生产，单核时生产者也能持续写入），并记录是否写出过指定内容
+class MarkerSink : public spdlog::sinks::base_sink<std::mutex> {
+public:
+    explicit MarkerSink(std::string marker) : marker_(std::move(marker)) {}
+    std::atomic<bool> seen{false};
+
+protected:
+    void sink_it_(const spdlog::details::log_msg& msg) override {
+        std::this_thread::yield();
+        if (std::string_view(msg.payload.data(), msg.payload.size()) == marker_) {
+            seen = true;
+        }
+    }
+    void flush_() override {}
+
+private:
+    const std::string marker_;
+};
+
+// 每线程环sink：其他线程持续写入时 flush 仍能返回，且已写出 flush 之前提交的记录
+TEST(ProjLoggerTest, ThreadRingSinkFlushUnderLoad) {
+    auto inner = std::make_shared<MarkerSink>("flush marker");
+    auto ring_sink = std::make_shared<proj_logger::ThreadRingSink>(inner, 4096, proj_logger::OverflowPolicy::BLOCK);
+    spdlog::logger logger("ring_flush", ring_sink);
+
+    std::atomic<bool> stop{false};
+    std::atomic<int> produced{0};
+    std::vector<std::thread> threads;
+    for (int t = 0; t < 2; ++t) {
+        threads.emplace_back([&]() {
+            while (!stop.load()) {
+                logger.info("busy {}", produced.fetch_add(1));
+            }
+        });
+    }
+    while (produced.load() < 1000) {
+        std::this_thread::yield();
+    }
+    logger.flush();
+    logger.info("flush marker");
+    logger.flush();
+    EXPECT_TRUE(inner->seen.load());
+    stop = true;
+    for (auto& t : threads) {
+        t.join();
+    }
+}
+
+// 二进制日志：调用点只记录原始参数，后台格式化结果与文本模式一致
+TEST(ProjLoggerTest, BinaryLogDeferredFormatting) {
+    if (proj_logger::binary_log_enabled()) {
+        GTEST_SKIP() << "binary mode enabled by environment";
+    }
+    std::ostringstream oss;
+    auto sink = std::make_shared<spdlog::sinks::ostream_sink_mt>(oss);
+    sink->set_pattern("%v");
+    const uint32_t site = proj_logger::register_log_site(
+        TEST_LOGGER_NAME, proj_logger::LogLevel::INFO, __FILE__, __LINE__, "v={:<4x}|s={}|f={:.1f}|b={}|c={}");
+
+    {
+        proj_logger::BinaryLogBackend backend(sink, "");
+        proj_logger::binary_log(site, 10, std::string("str"), 1.5, true, 'z');
+        std::thread t([&]() { proj_logger::binary_log(site, -1, "lit", 0.5, false, 'y'); });
+        t.join();
+        backend.flush();
+    }
+    EXPECT_NE(oss.str().find("v=a   |s=str|f=1.5|b=true|c=z"), std::string::npos) << oss.str();
+    EXPECT_NE(oss.str().find("v=-1  |s=lit|f=0.5|b=false|c=y"), std::string::npos) << oss.str();
+
+    // 结构化调用点：后台写出的记录带结构化标记，JSON行格式化器把字段并入对象
+    std::ostringstream json_oss;
+    auto json_sink = std::make_shared<spdlog::sinks::ostream_sink_mt>(json_oss);
+    json_sink->set_formatter(std::make_unique<proj_logger::JsonLineFormatter>());
+    const uint32_t kv_site = proj_logger::register_log_site(
+        TEST_LOGGER_NAME, proj_logger::LogLevel::INFO, __FILE__, __LINE__, "{}", true);
+    const uint32_t text_site = proj_logger::register_log_site(
+        TEST_LOGGER_NAME, proj_logger::LogLevel::INFO, __FILE__, __LINE__, "{}");
+    {
+        proj_logger::BinaryLogBackend backend(json_sink, "");
+        proj_logger::binary_log(kv_site, proj_logger::encode_structured("OpAdd", proj_logger::kv("id", 3)));
+        proj_logger::binary_log(text_site, std::string("{\"event\":\"fake\"}"));
+        backend.flush();
+    }
+    EXPECT_NE(json_oss.str().find("\"event\":\"OpAdd\",\"id\":3}\n"), std::string::npos) << json_oss.str();
+    EXPECT_NE(json_oss.str().find("\"msg\":\"{\\\"event\\\":\\\"fake\\\"}\"}\n"), std::string::npos)
+        << json_oss.str();
+
+    // 写二进制文件，再离线解码
+    const std::string path = ::testing::TempDir() + "ut_binary_log.plog";
+    {
+        proj_logger::BinaryLogBackend backend(nullptr, path);
+        proj_logger::binary_log(site, 255, "file", 2.5, true, 'x');
+    }
+    FILE* out = std::tmpfile();
+    ASSERT_NE(out, nullptr);
+    EXPECT_EQ(proj_logger::decode_binary_log_file(path, out), 1);
+    std::rewind(out);
+    char line[512] = {0};
+    ASSERT_NE(std::fgets(line, sizeof(line), out), nullptr);
+    std::fclose(out);
+    EXPECT_NE(std::string(line).find("[TEST] [info] [ut_proj.cpp:"), std::string::npos) << line;
+    EXPECT_NE(std::string(line).find("v=ff  |s=file|f=2.5|b=true|c=x"), std::string::npos) << line;
+
+    // 结构化调用点的标记写入调用点帧：按JSON行解码时字段并入对象，普通文本仍放入 "msg"
+    {
+        proj_logger::BinaryLogBackend backend(nullptr, path);
+        proj_logger::binary_log(kv_site, proj_logger::encode_structured("OpAdd", proj_logger::kv("id", 4)));
+        proj_logger::binary_log(text_site, std::string("{\"event\":\"fake\"}"));
+    }
+    out = std::tmpfile();
+    ASSERT_NE(out, nullptr);
+    EXPECT_EQ(proj_logger::decode_binary_log_file(path, out, true), 2);
+    std::rewind(out);
+    std::string decoded;
+    while (std::fgets(line, sizeof(line), out) != nullptr) {
+        decoded += line;
+    }
+    std::fclose(out);
+    EXPECT_NE(decoded.find("\"event\":\"OpAdd\",\"id\":4}\n"), std::string::npos) << decoded;
+    EXPECT_NE(decoded.find("\"msg\":\"{\\\"event\\\":\\\"fake\\\"}\"}\n"), std::string::npos) << decoded;
+}
+
+// 二进制日志：多线程持续写入时关闭后台，已登记的写入都被写出，其余计为丢弃
+TEST(ProjLoggerTest, BinaryLogShutdownUnderLoad) {
+    if (proj_logger::binary_log_enabled()) {
+        GTEST_SKIP() << "binary mode enabled by environment";
+    }
+    auto inner = std::make_shared<GateSink>();
+    const uint32_t site = proj_logger::register_log_site(
+        TEST_LOGGER_NAME, proj_logger::LogLevel::INFO, __FILE__, __LINE__, "t{} m{}");
+    const uint64_t dropped_before = proj_logger::BinaryLogBackend::dropped();
+
+    auto backend = std::make_unique<proj_logger::BinaryLogBackend>(inner, "");
+    std::atomic<bool> stop{false};
+    std::atomic<uint64_t> submitted{0};
+    std::vector<std::thread> threads;
+    for (int t = 0; t < 4; ++t) {
+        threads.emplace_back([&, t]() {
+            for (int i = 0; !stop.load(); ++i) {
+                proj_logger::binary_log(site, t, i);
+                submitted.fetch_add(1);
+            }
+        });
+    }
+    while (submitted.load() < 2000) {
+        std::this_thread::yield();
+    }
+    backend->shutdown();
+    stop = true;
+    for (auto& t : threads) {
+        t.join();
+    }
+    const uint64_t dropped = proj_logger::BinaryLogBackend::dropped() - dropped_before;
+    EXPECT_EQ(static_cast<uint64_t>(inner->count.load()) + dropped, submitted.load());
+}
+
+// 飞行记录器：输出级别为WARN时仍保留DEBUG/INFO上下文，ERROR触发转储，映射文件可离线解码
+TEST(ProjLoggerTest, FlightRecorderKeepsContextBelowOutputLevel) {
+    const std::string path = ::testing::TempDir() + "ut_flight.plog";
+    const std::string dump_path = ::testing::TempDir() + "ut_flight.log";
+    std::remove(dump_path.c_str());
+
+    std::ostringstream oss;
+    auto out_sink = std::make_shared<spdlog::sinks::ostream_sink_mt>(oss);
+    out_sink->set_level(spdlog::level::warn);
+    auto recorder = std::make_shared<proj_logger::FlightRecorder>(path, dump_path, 16);
+    recorder->set_level(spdlog::level::debug);
+    spdlog::logger logger("flight", {out_sink, recorder});
+    logger.set_level(spdlog::level::debug);
+    logger.set_pattern("%v");
+
+    for (int i = 0; i < 20; ++i) {
+        logger.debug("ctx {}", i);  // 只保留最近的16条
+    }
+    logger.error("boom");
+    EXPECT_EQ(oss.str(), "boom\n");
+
+    auto read_file = [](const std::string& file) {
+        std::ifstream in(file);
+        return std::string(std::istreambuf_iterator<char>(in), std::istreambuf_iterator<char>());
+    };
+    std::string dumped = read_file(dump_path);
+    EXPECT_EQ(dumped.find("ctx 4\n"), std::string::npos) << dumped;
+    EXPECT_NE(dumped.find("[flight] [debug] [:0] ctx 5\n"), std::string::npos) << dumped;
+    EXPECT_NE(dumped.find("[flight] [error] [:0] boom\n"), std::string::npos) << dumped;
+
+    // 再次转储只包含新记录
+    logger.info("after");
+    EXPECT_EQ(recorder->dump(), 1u);
+    std::string dumped_again = read_file(dump_path);
+    EXPECT_EQ(dumped_again.substr(0, dumped.size()), dumped);
+    EXPECT_NE(dumped_again.find("[flight] [info] [:0] after\n", dumped.size()), std::string::npos);
+
+    // 映射文件即使未转储也保留全部最近记录
+    FILE* out = std::tmpfile();
+    ASSERT_NE(out, nullptr);
+    EXPECT_EQ(proj_logger::decode_flight_file(path, out), 16);
+    std::fclose(out);
+}
+
+// mmap文件sink：写满按大小切换段，段关闭后截断到实际长度，内容按顺序完整
+TEST(ProjLoggerTest, MmapFileSinkRotatesBySize) {
+    const std::string base = ::testing::TempDir() + "ut_mmap_" + std::to_string(::getpid()) + ".log";
+    proj_logger::MmapFileSinkConfig config;
+    config.path = base;
+    config.segment_bytes = 4096;
+    const int kLines = 500;
+    {
+        auto sink = std::make_shared<proj_logger::MmapFileSink>(config);
+        spdlog::logger logger("mmap", sink);
+        logger.set_pattern("%v");
+        for (int i = 0; i < kLines; ++i) {
+            logger.info("line {:04d}", i);
+        }
+        EXPECT_NE(sink->current_path(), base + ".0");
+    }
+
+    std::string all;
+    int segments = 0;
+    for (;; ++segments) {
+        std::ifstream in(base + "." + std::to_string(segments), std::ios::binary);
+        if (!in) {
+            break;
+        }
+        std::string content((std::istreambuf_iterator<char>(in)), std::istreambuf_iterator<char>());
+        EXPECT_LE(content.size(), config.segment_bytes);
+        EXPECT_EQ(content.find('\0'), std::string::npos);
+        all += content;
+        std::remove((base + "." + std::to_string(segments)).c_str());
+    }
+    EXPECT_EQ(segments, static_cast<int>((kLines * 10 + config.segment_bytes - 1) / config.segment_bytes));
+
+    std::string expected;
+    for (int i = 0; i < kLines; ++i) {
+        expected += fmt::format("line {:04d}\n", i);
+    }
+    EXPECT_EQ(all, expected);
+}
+
+// mmap文件sink：超过段容量的记录截断写入并计数，以换行结尾，不切出空段；后续记录照常写入新段
+TEST(ProjLoggerTest, MmapFileSinkTruncatesOversizedRecord) {
+    const std::string base = ::testing::TempDir() + "ut_mmap_big_" + std::to_string(::getpid()) + ".log";
+    proj_logger::MmapFileSinkConfig config;
+    config.path = base;
+    config.segment_bytes = 4096;
+    {
+        auto sink = std::make_shared<proj_logger::MmapFileSink>(config);
+        spdlog::logger logger("mmap_big", sink);
+        logger.set_pattern("%v");
+        logger.info("{}", std::string(config.segment_bytes * 2, 'x'));
+        logger.info("after");
+        EXPECT_EQ(sink->truncated_count(), 1u);
+    }
+
+    std::vector<std::string> contents;
+    for (int i = 0;; ++i) {
+        std::ifstream in(base + "." + std::to_string(i), std::ios::binary);
+        if (!in) {
+            break;
+        }
+        contents.emplace_back((std::istreambuf_iterator<char>(in)), std::istreambuf_iterator<char>());
+        std::remove((base + "." + std::to_string(i)).c_str());
+    }
+    ASSERT_EQ(contents.size(), 2u);
+    EXPECT_EQ(contents[0], std::string(config.segment_bytes - 1, 'x') + "\n");
+    EXPECT_EQ(contents[1], "after\n");
+}
+
+// mmap文件sink：段文件创建失败时不留残留文件、序号不前进，退避期内的记录丢弃并计数
+TEST(ProjLoggerTest, MmapFileSinkBacksOffOnSegmentFailure) {
+    proj_logger::MmapFileSinkConfig bad;
+    bad.segment_bytes = 0;
+    EXPECT_THROW(proj_logger::MmapFileSink{bad}, std::invalid_argument);
+    EXPECT_THROW(proj_logger::LoggerManager::set_file_sink_config(bad), std::invalid_argument);
+
+    // 预分配失败（段大小超出文件系统上限）：创建的段文件被删除
+    const std::string base = ::testing::TempDir() + "ut_mmap_fail_" + std::to_string(::getpid()) + ".log";
+    proj_logger::MmapFileSinkConfig config;
+    config.path = base;
+    config.segment_bytes = size_t(1) << 60;
+    config.retry_interval = std::chrono::hours(1);
+    {
+        auto sink = std::make_shared<proj_logger::MmapFileSink>(config);
+        spdlog::logger logger("mmap_fail", sink);
+        logger.set_pattern("%v");
+        for (int i = 0; i < 100; ++i) {
+            logger.info("line {}", i);
+        }
+        EXPECT_EQ(sink->dropped_count(), 100u);
+        EXPECT_TRUE(sink->current_path().empty());
+    }
+    EXPECT_NE(::access((base + ".0").c_str(), F_OK), 0);
+    EXPECT_NE(::access((base + ".1").c_str(), F_OK), 0);
+
+    // 目录不存在时创建失败；恢复后从序号0开始写
+    const std::string dir = ::testing::TempDir() + "ut_mmap_dir_" + std::to_string(::getpid());
+    config.path = dir + "/seg.log";
+    config.segment_bytes = 4096;
+    config.retry_interval = std::chrono::milliseconds(0);
+    {
+        auto sink = std::make_shared<proj_logger::MmapFileSink>(config);
+        spdlog::logger logger("mmap_dir", sink);
+        logger.set_pattern("%v");
+        for (int i = 0; i < 10; ++i) {
+            logger.info("lost {}", i);
+        }
+        EXPECT_EQ(sink->dropped_count(), 10u);
+        ASSERT_EQ(::mkdir(dir.c_str(), 0755), 0);
+        logger.info("ok");
+        EXPECT_EQ(sink->current_path(), config.path + ".0");
+    }
+    std::ifstream in(config.path + ".0", std::ios::binary);
+    std::string content((std::istreambuf_iterator<char>(in)), std::istreambuf_iterator<char>());
+    EXPECT_EQ(content, "ok\n");
+    std::remove((config.path + ".0").c_str());
+    ::rmdir(dir.c_str());
+}
+
 // 基础功能测试（原EventHandlerTest改为ApiBaseTest）
 TEST(ApiBaseTest, BasicFunctionality) {
     proj::event::ApiBase api;
@@ -154,6 +934,81 @@ TEST(ApiBaseTest, ThreadSafety) {
     EXPECT_EQ(total_processed, kThreadCount * kEventsPerThread);
 }
 
+// 处理过程中并发注册：处理线程始终看到完整的快照（旧处理器或新处理器之一）
+TEST(ApiBaseTest, ConcurrentRegisterWhileProcessing) {
+    proj::event::ApiBase api;
+    std::atomic<int> old_calls(0), new_calls(0);
+    api.register_handler<proj::event::OpAddEvent>([&](const proj::event::OpAddEvent&) { old_calls++; });
+
+    const int kThreadCount = 4;
+    const int kEventsPerThread = 20000;
+    std::atomic<bool> start(false);
+    std::vector<std::thread> threads;
+    for (int t = 0; t < kThreadCount; ++t) {
+        threads.emplace_back([&]() {
+            proj::event::OpAddEvent event("add", "a", "b", "c");
+            while (!start.load()) {
+                std::this_thread::yield();
+            }
+            for (int i = 0; i < kEventsPerThread; ++i) {
+                api.process(event);
+            }
+        });
+    }
+    start = true;
+    for (int i = 0; i < 100; ++i) {
+        api.register_handler<proj::event::OpAddEvent>([&](const proj::event::OpAddEvent&) { new_calls++; });
+        api.register_handler<proj::event::TensorEvent>([](const proj::event::TensorEvent&) {});
+    }
+    for (auto& t : threads) {
+        t.join();
+    }
+
+    EXPECT_EQ(old_calls + new_calls, kThreadCount * kEventsPerThread);
+    proj::event::OpAddEvent event("add", "a", "b", "c");
+    api.process(event);
+    EXPECT_EQ(old_calls + new_calls, kThreadCount * kEventsPerThread + 1);
+}
+
+// 持续处理时反复注册：退休快照按宽限期逐代回收，不随注册次数累积到析构
+TEST(ApiBaseTest, RetiredSnapshotsReclaimedUnderLoad) {
+    proj::event::ApiBase api;
+    std::atomic<int> calls(0);
+    api.register_handler<proj::event::OpAddEvent>([&](const proj::event::OpAddEvent&) { calls++; });
+
+    const int kThreadCount = 4;
+    const int kRegistrations = 2000;
+    std::atomic<bool> stop(false);
+    std::vector<std::thread> threads;
+    for (int t = 0; t < kThreadCount; ++t) {
+        threads.emplace_back([&]() {
+            proj::event::OpAddEvent event("add", "a", "b", "c");
+            while (!stop.load()) {
+                api.process(event);
+            }
+        });
+    }
+    while (calls.load() < 1000) {
+        std::this_thread::yield();
+    }
+    size_t max_retired = 0;
+    for (int i = 0; i < kRegistrations; ++i) {
+        api.register_handler<proj::event::OpAddEvent>([&](const proj::event::OpAddEvent&) { calls++; });
+        max_retired = std::max(max_retired, api.retired_snapshot_count());
+        std::this_thread::sleep_for(std::chrono::microseconds(20));
+    }
+    stop = true;
+    for (auto& t : threads) {
+        t.join();
+    }
+    EXPECT_LT(max_retired, static_cast<size_t>(kRegistrations / 2));
+
+    // 无读者时两次发布后只剩最近一代退休的快照
+    api.register_handler<proj::event::OpAddEvent>([&](const proj::event::OpAddEvent&) { calls++; });
+    api.register_handler<proj::event::OpAddEvent>([&](const proj::event::OpAddEvent&) { calls++; });
+    EXPECT_EQ(api.retired_snapshot_count(), 1u);
+}
+
 // 析构线程安全测试：验证对象销毁后调用process/register_handler不会崩溃
 TEST(ApiBaseTest, DestructionThreadSafety) {
     std::atomic<bool> test_done(false);
@@ -187,6 +1042,256 @@ TEST(ApiBaseTest, DestructionThreadSafety) {
     EXPECT_TRUE(true);
 }
 
+// 析构压力测试：多线程处理器执行中析构，析构必须等所有在途处理器结束后才返回
+TEST(ApiBaseTest, DestructionWaitsForInFlightHandlers) {
+    constexpr int kThreads = 8;
+    for (int round = 0; round < 50; ++round) {
+        auto api = std::make_unique<proj::event::ApiBase>();
+        std::atomic<int> entered(0);
+        std::atomic<int> finished(0);
+        api->register_handler<proj::event::OpAddEvent>([&](const proj::event::OpAddEvent&) {
+            entered.fetch_add(1);
+            // 处理时长错开，部分处理器在析构开始后才结束
+            auto until = std::chrono::steady_clock::now() + std::chrono::microseconds(200 * (round % 5));
+            while (std::chrono::steady_clock::now() < until) {
+                std::this_thread::yield();
+            }
+            finished.fetch_add(1);
+        });
+
+        const proj::event::OpAddEvent event("add", "t0", "t1", "t2");
+        std::vector<std::thread> threads;
+        for (int t = 0; t < kThreads; ++t) {
+            threads.emplace_back([&]() { api->process(event); });
+        }
+        // 所有线程都进入处理器后再析构，之后不再有新的 process 调用
+        while (entered.load() < kThreads) {
+            std::this_thread::yield();
+        }
+        api.reset();
+        EXPECT_EQ(finished.load(), kThreads) << "round " << round;
+        for (auto& t : threads) {
+            t.join();
+        }
+    }
+}
+
+// 异步投递：future/回调获取结果，拒绝策略下队列满立即返回，析构前排空已入队事件
+TEST(ApiBaseTest, PostToWorkerPool) {
+    std::atomic<int> handled(0);
+    {
+        proj::event::ApiBase api(proj::event::PostConfig{2, 64, BackpressurePolicy::BLOCK, nullptr});
+        api.register_handler<proj::event::OpAddEvent>([&](const proj::event::OpAddEvent&) {
+            handled.fetch_add(1);
+        });
+
+        auto result = api.post_future(proj::event::OpAddEvent("add_0", "t0", "t1", "t2"));
+        EXPECT_TRUE(result.get());
+
+        std::atomic<int> callbacks(0);
+        for (int i = 0; i < 500; ++i) {
+            EXPECT_TRUE(api.post(proj::event::OpAddEvent("add", "t0", "t1", "t2"),
+                                 [&](bool ok) { callbacks.fetch_add(ok ? 1 : 0); }));
+        }
+        api.drain();
+        EXPECT_EQ(callbacks.load(), 500);
+
+        // 析构时排空：不调用drain，已入队的事件仍全部处理
+        for (int i = 0; i < 100; ++i) {
+            api.post(proj::event::OpAddEvent("add", "t0", "t1", "t2"));
+        }
+    }
+    EXPECT_EQ(handled.load(), 601);
+
+    // 拒绝策略：唯一的工作线程被阻塞、队列占满后，post 立即返回false并回调失败
+    proj::event::ApiBase api(proj::event::PostConfig{1, 2, BackpressurePolicy::REJECT, nullptr});
+    std::promise<void> release;
+    std::shared_future<void> gate = release.get_future().share();
+    api.register_handler<proj::event::TensorEvent>([gate](const proj::event::TensorEvent&) { gate.wait(); });
+
+    int accepted = 0;
+    std::atomic<int> failed(0);
+    for (int i = 0; i < 8; ++i) {
+        if (api.post(proj::event::TensorEvent("t", {1}, "float32"), [&](bool ok) { failed += ok ? 0 : 1; })) {
+            ++accepted;
+        }
+    }
+    EXPECT_LE(accepted, 3); // 1个执行中 + 2个排队
+    EXPECT_EQ(failed.load(), 8 - accepted);
+    release.set_value();
+    api.drain();
+}
+
+// 批量处理：整批查表一次；有批量处理器时整批调用一次，重新注册单事件处理器后回退为逐个调用
+TEST(ApiBaseTest, ProcessBatch) {
+    proj::event::ApiBase api;
+    std::vector<proj::event::OpAddEvent> events;
+    for (int i = 0; i < 16; ++i) {
+        events.emplace_back("add_" + std::to_string(i), "t0", "t1", "t2");
+    }
+
+    int single_calls = 0;
+    api.register_handler<proj::event::OpAddEvent>([&](const proj::event::OpAddEvent&) { ++single_calls; });
+    api.process_batch<proj::event::OpAddEvent>(events);
+    EXPECT_EQ(single_calls, 16);
+
+    int batch_calls = 0;
+    size_t batch_size = 0;
+    api.register_batch_handler<proj::event::OpAddEvent>([&](Span<const proj::event::OpAddEvent> batch) {
+        ++batch_calls;
+        batch_size += batch.size();
+        EXPECT_EQ(batch[3].name(), "add_3");
+    });
+    api.process_batch<proj::event::OpAddEvent>(events);
+    api.process(events[0]); // 已有单事件处理器，单个处理不走批量
+    EXPECT_EQ(batch_calls, 1);
+    EXPECT_EQ(batch_size, 16u);
+    EXPECT_EQ(single_calls, 17);
+
+    api.register_handler<proj::event::OpAddEvent>([&](const proj::event::OpAddEvent&) { ++single_calls; });
+    api.process_batch<proj::event::OpAddEvent>(Span<const proj::event::OpAddEvent>(events.data(), 4));
+    EXPECT_EQ(batch_calls, 1);
+    EXPECT_EQ(single_calls, 21);
+
+    // 内置TensorHandler提供批量重载，延迟注册时一并安装
+    std::vector<proj::event::TensorEvent> tensors(3, proj::event::TensorEvent("t", {2, 2}, "float32"));
+    api.process_batch<proj::event::TensorEvent>(tensors);
+
+    proj::msg::Router router;
+    int routed = 0;
+    router.get_add_processor()->register_impl("batch_add", [&](const proj::msg::OpAddMsg&) { ++routed; });
+    std::array<proj::msg::OpAddMsg, 3> msgs = {
+        proj::msg::OpAddMsg("batch_add", "a", "b", "c"),
+        proj::msg::OpAddMsg("batch_add", "a", "b", "c"),
+        proj::msg::OpAddMsg("batch_add", "a", "b", "c"),
+    };
+    router.dispatch_batch<proj::msg::OpAddMsg>(msgs);
+    EXPECT_EQ(routed, 3);
+}
+
+// 工作窃取执行器：工作线程内嵌套提交的任务全部完成，可作为ApiBase与Router共享的异步后端
+TEST(ApiBaseTest, WorkStealingExecutorBackend) {
+    auto executor = std::make_shared<WorkStealingExecutor>(3, 256);
+    std::atomic<int> leaves(0);
+    for (int i = 0; i < 20; ++i) {
+        executor->submit([&, executor_ptr = executor.get()]() {
+            for (int j = 0; j < 50; ++j) {
+                executor_ptr->submit([&]() { leaves.fetch_add(1); });
+            }
+        });
+    }
+    executor->drain();
+    EXPECT_EQ(leaves.load(), 1000);
+
+    std::atomic<int> handled(0);
+    {
+        proj::event::PostConfig config;
+        config.executor = executor;
+        proj::event::ApiBase api(config);
+        api.register_handler<proj::event::TensorEvent>([&](const proj::event::TensorEvent&) {
+            handled.fetch_add(1);
+        });
+        for (int i = 0; i < 200; ++i) {
+            api.post(proj::event::TensorEvent("t", {1}, "float32"));
+        }
+    }
+    EXPECT_EQ(handled.load(), 200);
+
+    proj::msg::Router router;
+    std::atomic<int> routed(0);
+    router.get_add_processor()->register_impl("ws_add", [&](const proj::msg::OpAddMsg&) { routed.fetch_add(1); });
+    router.set_executor(executor);
+    for (int i = 0; i < 100; ++i) {
+        router.post<proj::msg::OpAddMsg>("ws_add", "t0", "t1", "t2");
+    }
+    router.drain();
+    EXPECT_EQ(routed.load(), 100);
+}
+
+// 工作窃取执行器：队列固定容量；工作线程本地队列满时落到其他队列，总容量用满后按背压策略拒绝
+TEST(ApiBaseTest, WorkStealingExecutorSpillsWhenLocalQueueFull) {
+    WorkStealingExecutor executor(3, 6, BackpressurePolicy::REJECT);
+    std::atomic<bool> release(false);
+    std::atomic<int> started(0);
+    std::atomic<int> children(0);
+    std::atomic<int> accepted(0);
+    auto block = [&]() {
+        started.fetch_add(1);
+        while (!release.load()) {
+            std::this_thread::yield();
+        }
+    };
+    for (int i = 0; i < 2; ++i) {
+        ASSERT_TRUE(executor.submit(block));
+    }
+    while (started.load() < 2) {
+        std::this_thread::yield();
+    }
+    ASSERT_TRUE(executor.submit([&]() {
+        for (int i = 0; i < 5; ++i) {
+            accepted.fetch_add(executor.submit([&]() { children.fetch_add(1); }) ? 1 : 0);
+        }
+        block();
+    }));
+    while (started.load() < 3) {
+        std::this_thread::yield();
+    }
+    EXPECT_EQ(accepted.load(), 5);
+    EXPECT_TRUE(executor.submit([&]() { children.fetch_add(1); }));
+    EXPECT_FALSE(executor.submit([&]() { children.fetch_add(1); }));
+    release = true;
+    executor.drain();
+    EXPECT_EQ(children.load(), 6);
+}
+
+// 共享执行器：析构与 drain 只等待本对象投递的任务，不被其他使用方阻塞；可在执行器任务中析构
+TEST(ApiBaseTest, SharedExecutorDrainsOnlyOwnPosts) {
+    auto executor = std::make_shared<ThreadPool>(2, 64);
+    std::atomic<bool> release(false);
+    executor->submit([&]() {
+        while (!release.load()) {
+            std::this_thread::sleep_for(std::chrono::milliseconds(1));
+        }
+    });
+
+    std::atomic<int> handled(0);
+    proj::event::PostConfig config;
+    config.executor = executor;
+    {
+        proj::event::ApiBase api(config);
+        api.register_handler<proj::event::TensorEvent>([&](const proj::event::TensorEvent&) {
+            handled.fetch_add(1);
+        });
+        for (int i = 0; i < 10; ++i) {
+            api.post(proj::event::TensorEvent("t", {1}, "float32"));
+        }
+    } // 外部任务仍阻塞时析构返回
+    EXPECT_EQ(handled.load(), 10);
+
+    proj::msg::Router router;
+    std::atomic<int> routed(0);
+    router.get_add_processor()->register_impl("shared_add", [&](const proj::msg::OpAddMsg&) { routed.fetch_add(1); });
+    router.set_executor(executor);
+    for (int i = 0; i < 10; ++i) {
+        router.post<proj::msg::OpAddMsg>("shared_add", "t0", "t1", "t2");
+    }
+    router.drain();
+    EXPECT_EQ(routed.load(), 10);
+
+    // 在共享执行器的任务中析构
+    auto api = std::make_unique<proj::event::ApiBase>(config);
+    api->post(proj::event::TensorEvent("t", {1}, "float32"));
+    std::promise<void> destroyed;
+    executor->submit([&]() {
+        api.reset();
+        destroyed.set_value();
+    });
+    EXPECT_EQ(destroyed.get_future().wait_for(std::chrono::seconds(5)), std::future_status::ready);
+
+    release = true;
+    executor->drain();
+}
+
 // ApiBaseSingle单线程功能测试
 TEST(ApiBaseSingleTest, SingleThreadFunctionality) {
     TEST_INFO("Start ApiBaseSingle single thread test");
@@ -223,6 +1328,46 @@ TEST(ApiBaseSingleTest, SingleThreadFunctionality) {
     TEST_WARN("ApiBaseSingle single thread test finished");
 }
 
+// 跨线程邮箱：其他线程submit不抛异常，事件由绑定线程run_until取出处理
+TEST(ApiBaseSingleTest, MailboxCrossThreadSubmit) {
+    constexpr int kProducers = 4;
+    constexpr int kEventsPerProducer = 1000;
+    proj::event::ApiBaseSingle api(256);
+    int handled = 0; // 只在绑定线程访问，无需同步
+    std::thread::id handler_thread;
+    api.register_handler<proj::event::OpAddEvent>([&](const proj::event::OpAddEvent&) {
+        handler_thread = std::this_thread::get_id();
+        ++handled;
+    });
+
+    std::vector<std::thread> producers;
+    for (int p = 0; p < kProducers; ++p) {
+        producers.emplace_back([&]() {
+            for (int i = 0; i < kEventsPerProducer; ++i) {
+                // 邮箱满时由生产者自行重试
+                while (!api.submit(proj::event::OpAddEvent("add", "t0", "t1", "t2"))) {
+                    std::this_thread::yield();
+                }
+            }
+        });
+    }
+    size_t total = api.run_until([&]() { return handled == kProducers * kEventsPerProducer; });
+    for (auto& t : producers) {
+        t.join();
+    }
+    EXPECT_EQ(total, static_cast<size_t>(kProducers * kEventsPerProducer));
+    EXPECT_EQ(handler_thread, std::this_thread::get_id());
+    EXPECT_EQ(api.run_once(), 0u);
+
+    // 超时返回
+    auto deadline = std::chrono::steady_clock::now() + std::chrono::milliseconds(5);
+    EXPECT_EQ(api.run_until(deadline), 0u);
+
+    // 非绑定线程不能驱动邮箱
+    std::thread other([&]() { EXPECT_THROW(api.run_once(), std::runtime_error); });
+    other.join();
+}
+
 // ApiBaseSingle多线程错误测试
 TEST(ApiBaseSingleTest, MultiThreadError) {
     TEST_INFO("Start ApiBaseSingle multi thread error test");
@@ -365,6 +1510,56 @@ TEST(RouterTest, OpAdd_Custom_Impl_Registration) {
     EXPECT_EQ(custom_call_count, 2);
 }
 
+TEST(RouterTest, OpAdd_Frozen_Impl_Table) {
+    // 测试目标：未命中走缓存的默认实现；注册与无锁查找并发时，读者最终看到新实现
+    Router router;
+    OpAddProcessor* processor = router.get_add_processor();
+    const OpAddProcessor::ImplFunc* fallback = processor->find_impl("no_such_impl");
+    ASSERT_NE(fallback, nullptr);
+    EXPECT_EQ(processor->find_impl("default"), fallback);
+    EXPECT_NE(processor->find_impl("special"), fallback);
+
+    std::atomic<bool> found{false};
+    std::thread reader([&]() {
+        while (processor->find_impl("late_impl") == fallback) {
+            std::this_thread::yield();
+        }
+        found = true;
+    });
+    int late_calls = 0;
+    for (int i = 0; i < 16; ++i) {
+        processor->register_impl("filler_" + std::to_string(i), [](const OpAddMsg&) {});
+    }
+    processor->register_impl("late_impl", [&](const OpAddMsg&) { ++late_calls; });
+    reader.join();
+    EXPECT_TRUE(found);
+
+    router.dispatch(OpAddMsg("late_impl", "in1", "in2", "out"));
+    EXPECT_EQ(late_calls, 1);
+
+    // 注册时驻留实现名，按消息名查找到的符号即得到同一实现
+    const OpAddMsg symbol_msg("late_impl", "in1", "in2", "out");
+    ASSERT_FALSE(symbol_msg.name_symbol().empty());
+    EXPECT_EQ(processor->find_impl(symbol_msg.name_symbol()), processor->find_impl("late_impl"));
+    EXPECT_EQ(processor->find_impl(Symbol()), fallback);
+
+    // 消息先于实现注册构造（构造时名字尚未驻留），分发时按名字查找仍能找到新实现
+    const OpAddMsg early_msg("registered_later", "in1", "in2", "out");
+    EXPECT_TRUE(early_msg.name_symbol().empty());
+    int later_calls = 0;
+    processor->register_impl("registered_later", [&](const OpAddMsg&) { ++later_calls; });
+    router.dispatch(early_msg);
+    EXPECT_EQ(later_calls, 1);
+    EXPECT_THROW(processor->register_impl("", [](const OpAddMsg&) {}), std::invalid_argument);
+
+    // 替换默认实现后，未命中的消息走新的默认实现
+    int default_calls = 0;
+    processor->register_impl("default", [&](const OpAddMsg&) { ++default_calls; });
+    EXPECT_NE(processor->find_impl("no_such_impl"), fallback);
+    router.dispatch(OpAddMsg("no_such_impl", "in1", "in2", "out"));
+    EXPECT_EQ(default_calls, 1);
+}
+
 // // ========================== 类型安全测试 ==========================
 TEST(RouterTest, Type_Safety_Checks) {
     Router router;
@@ -374,9 +1569,20 @@ TEST(RouterTest, Type_Safety_Checks) {
     EXPECT_EQ(add_event.type_index(), OpAddMsg::TypeIndex());
     EXPECT_NE(add_event.type_index(), OpMMAMsg::TypeIndex());
 
+    // 稠密类型ID：同一类型稳定，不同类型不同，且都落在已分配范围内
+    EXPECT_EQ(OpAddMsg::TypeId(), OpAddMsg::TypeId());
+    EXPECT_NE(OpAddMsg::TypeId(), OpMMAMsg::TypeId());
+    EXPECT_LT(OpAddMsg::TypeId(), DenseTypeId<proj::msg::MsgIdDomain>::count());
+    EXPECT_LT(OpMMAMsg::TypeId(), DenseTypeId<proj::msg::MsgIdDomain>::count());
+
     // 2. 运行时获取处理器（类型安全）
     EXPECT_NO_THROW(router.get_processor<OpAddMsg>());
     EXPECT_NO_THROW(router.get_processor<OpMMAMsg>());
+    // 处理器按类型直接取成员：返回裸指针，多次获取地址相同
+    static_assert(std::is_same_v<decltype(router.get_processor<OpAddMsg>()), OpAddProcessor*>,
+                  "get_processor returns a raw pointer");
+    EXPECT_EQ(router.get_processor<OpAddMsg>(), router.get_add_processor());
+    EXPECT_NE(router.get_processor<OpMMAMsg>(), nullptr);
 
     // 3. 测试获取未注册的处理器（抛异常）
     // 注意：这里无法模板实例化
@@ -449,6 +1655,131 @@ TEST(RouterTest, Thread_Safety_In_Single_Thread_Model) {
     EXPECT_EQ(total_processed, kThreadCount * kMsgsPerThread);
 }
 
+TEST(RouterTest, Concurrent_Dispatch_Mode) {
+    // 测试目标：并发模式下可重入处理器可被多个线程同时执行；串行模式下同一时刻只处理一条
+    static_assert(IsReentrantProcessor<OpAddProcessor>::value, "OpAddProcessor is reentrant");
+    static_assert(IsReentrantProcessor<OpMMAProcessor>::value, "OpMMAProcessor is reentrant");
+    static_assert(!IsReentrantProcessor<int>::value, "undeclared processors are not reentrant");
+
+    auto max_overlap = [](DispatchMode mode) {
+        Router router(mode);
+        EXPECT_EQ(router.dispatch_mode(), mode);
+        std::atomic<int> in_flight{0};
+        std::atomic<int> max_in_flight{0};
+        router.get_add_processor()->register_impl("overlap", [&](const OpAddMsg&) {
+            const int now = ++in_flight;
+            int seen = max_in_flight.load();
+            while (now > seen && !max_in_flight.compare_exchange_weak(seen, now)) {
+            }
+            std::this_thread::sleep_for(std::chrono::milliseconds(2));
+            --in_flight;
+        });
+
+        std::vector<std::thread> threads;
+        for (int t = 0; t < 4; ++t) {
+            threads.emplace_back([&router]() {
+                for (int i = 0; i < 5; ++i) {
+                    router.dispatch(OpAddMsg("overlap", "in1", "in2", "out"));
+                }
+            });
+        }
+        for (auto& t : threads) {
+            t.join();
+        }
+        return max_in_flight.load();
+    };
+
+    EXPECT_EQ(max_overlap(DispatchMode::SERIALIZED), 1);
+    EXPECT_GT(max_overlap(DispatchMode::CONCURRENT), 1);
+}
+
+// 自定义分片键的消息：按会话号分片，而不是按名称
+class SessionKeyedMsg : public MsgCRTP<SessionKeyedMsg> {
+public:
+    SessionKeyedMsg(std::string name, uint64_t session) : name_(std::move(name)), session_(session) {}
+    const std::string& name_impl() const { return name_; }
+    uint64_t key_impl() const { return session_; }
+
+private:
+    std::string name_;
+    uint64_t session_;
+};
+
+TEST(RouterTest, Sharded_Lanes_Keep_Per_Key_Order) {
+    // 测试目标：分片执行时同名消息按投递顺序在同一通道执行
+    const int kKeys = 4;
+    const int kMsgsPerKey = 100;
+    Router router(DispatchMode::CONCURRENT);
+    auto lanes = std::make_shared<ShardedExecutor>(3);
+    router.set_sharded_executor(lanes);
+
+    std::vector<std::vector<int>> seen(kKeys);
+    std::vector<std::set<std::thread::id>> threads(kKeys);
+    for (int k = 0; k < kKeys; ++k) {
+        router.get_add_processor()->register_impl("key_" + std::to_string(k), [&, k](const OpAddMsg& msg) {
+            // 同键只在一个通道上执行，无需加锁
+            seen[k].push_back(std::stoi(msg.input1()));
+            threads[k].insert(std::this_thread::get_id());
+        });
+    }
+
+    for (int i = 0; i < kMsgsPerKey; ++i) {
+        for (int k = 0; k < kKeys; ++k) {
+            router.post<OpAddMsg>("key_" + std::to_string(k), std::to_string(i), "in2", "out");
+        }
+    }
+    router.drain();
+
+    for (int k = 0; k < kKeys; ++k) {
+        ASSERT_EQ(seen[k].size(), static_cast<size_t>(kMsgsPerKey));
+        for (int i = 0; i < kMsgsPerKey; ++i) {
+            EXPECT_EQ(seen[k][i], i) << "key_" << k;
+        }
+        EXPECT_EQ(threads[k].size(), 1u);
+    }
+
+    // 未定义 key_impl() 时按名称散列；定义后以自定义键为准，不同名称的同会话消息进入同一通道
+    EXPECT_EQ(OpAddMsg("key_0", "in1", "in2", "out").key(), std::hash<std::string_view>{}("key_0"));
+    SessionKeyedMsg login("login", 42);
+    SessionKeyedMsg logout("logout", 42);
+    EXPECT_EQ(login.key(), 42u);
+    EXPECT_NE(login.key(), std::hash<std::string_view>{}("login"));
+    EXPECT_EQ(lanes->lane_of(login.key()), lanes->lane_of(logout.key()));
+}
+
+TEST(RouterTest, Static_Router_Variant_Dispatch) {
+    // 测试目标：编译期路由、variant 异构流分发与 OpMMA→OpAdd 重定向规则
+    using Static = StaticRouter<OpAddMsg, OpMMAMsg>;
+    static_assert(Static::kRoutes<OpAddMsg> && Static::kRoutes<OpMMAMsg>, "closed message set");
+    Static router;
+
+    std::vector<std::string> seen;
+    router.get_processor<OpAddMsg>()->register_impl("static_add", [&](const OpAddMsg& msg) {
+        seen.push_back(msg.name());
+    });
+    router.get_processor<OpAddMsg>()->register_impl("bad_mma_redirected", [&](const OpAddMsg& msg) {
+        seen.push_back(msg.name() + ":" + msg.input1() + ":" + msg.input2());
+    });
+
+    router.dispatch(OpAddMsg("static_add", "in1", "in2", "out"));
+    router.dispatch(OpMMAMsg("bad_mma", "a", "b", "", "out"));
+    router.dispatch(OpMMAMsg("good_mma", "a", "b", "c", "out")); // 走 OpMMA 处理器，不计入 seen
+
+    // 异构消息流：消息不可移动，就地构造到 deque 中
+    std::deque<Static::MsgVariant> stream;
+    stream.emplace_back(std::in_place_type<OpAddMsg>, "static_add", "x", "y", "z");
+    stream.emplace_back(std::in_place_type<OpMMAMsg>, "bad_mma", "p", "q", "", "r");
+    for (const auto& msg : stream) {
+        router.dispatch(msg);
+    }
+    const OpAddMsg by_ref("static_add", "in1", "in2", "out");
+    router.dispatch(Static::MsgRef(&by_ref));
+
+    const std::vector<std::string> expected = {
+        "static_add", "bad_mma_redirected:a:b", "static_add", "bad_mma_redirected:p:q", "static_add"};
+    EXPECT_EQ(seen, expected);
+}
+
 // ========================== 边界场景测试 ==========================
 TEST(RouterTest, Edge_Cases) {
     Router router;
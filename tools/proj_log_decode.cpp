@@ -0,0 +1,32 @@
+#include "../proj_logger/proj_logger.h"
+#include <cstdio>
+#include <cstring>
+
+// 解码 PROJ_LOG_BINARY_FILE 写出的二进制日志或 PROJ_LOG_FLIGHT_FILE 飞行记录文件，
+// 按文本模式的格式输出到stdout；--json 时二进制日志按JSON行格式输出（结构化调用点字段并入对象）
+// 用法：proj_log_decode [--json] <file> [<file> ...]
+int main(int argc, char** argv) {
+    int first = 1;
+    bool json = false;
+    if (argc > 1 && std::strcmp(argv[1], "--json") == 0) {
+        json = true;
+        first = 2;
+    }
+    if (argc <= first) {
+        std::fprintf(stderr, "usage: %s [--json] <binary_log_file|flight_file> [...]\n", argv[0]);
+        return 2;
+    }
+
+    int ret = 0;
+    for (int i = first; i < argc; ++i) {
+        long count = proj_logger::decode_binary_log_file(argv[i], stdout, json);
+        if (count < 0) {
+            count = proj_logger::decode_flight_file(argv[i], stdout);
+        }
+        if (count < 0) {
+            std::fprintf(stderr, "%s: not a proj binary log or flight recorder file\n", argv[i]);
+            ret = 1;
+        }
+    }
+    return ret;
+}